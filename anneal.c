@@ -0,0 +1,228 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** anneal.c ****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "anneal.h".                 *
+ ****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "arena.h"
+#include "timer.h"
+#include "score.h"
+#include "sample.h"
+#include "anneal.h"
+
+/*
+ * Number of insertions tried between two readings of the clock.
+ */
+#define ANNEAL_CLOCK 16
+
+/*
+ * Number of crossings of a placed word.
+ * cw : the crossword.
+ * wl : the list of words.
+ * pw : the word.
+ */
+static int anneal_crossings(crossword cw, word_list wl, placed_word* pw){
+  int len = wl->l[pw->w].len;
+  int x = pw->posx;
+  int y = pw->posy;
+  int k, nb = 0;
+
+  for(k = 0; k < len; k++){
+    if(pw->orient == HORIZONTAL) nb += (cw->vblock[x + k + 1] >> (y + 1)) & 1;
+    else nb += (cw->hblock[y + k + 1] >> (x + 1)) & 1;
+  }
+  return nb;
+}
+
+/*
+ * Add words to a journaled crossword, recording the mark before each of them
+ * (see cw_mark), so that the crossword can be rolled back to any word.
+ * cw    : the crossword (journaled).
+ * wl    : the list of words.
+ * pw    : the words.
+ * nb    : the number of words.
+ * marks : marks of the words of the crossword (updated).
+ * l     : label.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+static int anneal_add(crossword cw, word_list wl, placed_word* pw, int nb,
+                      int* marks, int* l){
+  int k;
+
+  for(k = 0; k < nb; k++){
+    marks[cw->nb_words] = cw_mark(cw);
+    if(0 != cw_add_word(cw, wl, pw[k].w, pw[k].posx, pw[k].posy,
+                        pw[k].orient, l))
+      return -1;
+  }
+  return 0;
+}
+
+/*
+ * Improve a crossword by local search.
+ * cw       : the crossword (improved in place).
+ * wl       : the list of words.
+ * rn       : the random generator.
+ * deadline : the end of the search (see timer.h).
+ * sw       : the weights of the score.
+ * ws       : the sampler of the list (see sample.h), NULL if the list is
+ *            small enough to be used as a whole.
+ * verbose  : if set to 1 verbose mode. 0 otherwise.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_anneal(crossword cw, word_list wl, rng* rn, long deadline,
+              score_weights* sw, word_sampler* ws, int verbose){
+  crossword work = NULL;
+  arena mem;
+  placed_word* cur;      // Current crossword (the words of work).
+  placed_word* best;     // Best crossword.
+  placed_word* kept;     // Words kept by a step, after the first removed.
+  int* marks;            // Marks of the words of work (see cw_mark).
+  char* rm;              // Words removed by a step.
+  int* subset = NULL;    // Words that can be inserted by a step.
+  char* drawn = NULL;    // Marks of the sampler (see sampler_draw).
+  int nb_cur, nb_best, nb_kept, nb_leaves, first, nb_sub;
+  long score_cur, score_best, score, threshold;
+  long start, total, now, iter = 0;
+  int nw = wl->next_free;
+  int max = 2 * cw->width * cw->height + 1; // Words in a grid, plus one.
+  int k, j, n, l, nb_rm;
+  int res = 0;
+
+  start = timer_now();
+  total = deadline - start;
+  if((0 == cw->nb_words) || (TIMER_NONE == deadline) || (total <= 0))
+    return 0;
+
+  if(max > nw + 1) max = nw + 1;
+  arena_init(&mem, 3 * max * sizeof(placed_word) + max * (sizeof(int) + 1) +
+                   (NULL != ws ? ws->size * sizeof(int) + nw : 0) +
+                   7 * ARENA_ALIGN);
+  cur = arena_alloc(&mem, max * sizeof(placed_word));
+  best = arena_alloc(&mem, max * sizeof(placed_word));
+  kept = arena_alloc(&mem, max * sizeof(placed_word));
+  marks = arena_alloc(&mem, max * sizeof(int));
+  rm = arena_alloc(&mem, max);
+  if(NULL != ws){
+    subset = arena_alloc(&mem, ws->size * sizeof(int));
+    if(NULL != (drawn = arena_alloc(&mem, nw))) memset(drawn, 0, nw);
+  }
+  if((NULL == cur) || (NULL == best) || (NULL == kept) || (NULL == marks) ||
+     (NULL == rm) || ((NULL != ws) && ((NULL == subset) || (NULL == drawn))) ||
+     (0 != cw_init(&work, cw->width, cw->height, nw)) ||
+     (0 != cw_journal_init(work))){
+    fprintf(stderr, "Memory allocation error in cw_anneal !\n");
+    if(NULL != work) cw_free(work);
+    arena_free(&mem);
+    return -1;
+  }
+
+  // The working crossword is built once, then changed through its journal.
+  nb_cur = nb_best = cw->nb_words;
+  memcpy(cur, cw->words, nb_cur * sizeof(placed_word));
+  memcpy(best, cw->words, nb_best * sizeof(placed_word));
+  score_cur = score_best = cw_score(cw, sw);
+  l = 1;
+  res = anneal_add(work, wl, cur, nb_cur, marks, &l);
+
+  for(now = start; (0 == res) && (now < deadline); iter++){
+    // The threshold goes from the weight of two words to zero.
+    threshold = 2 * sw->words * (deadline - now) / total;
+    if(threshold < 0) threshold = 0;
+
+    // Choose some leaf words (crossing a single word, so that the grid
+    // stays connected) at random.
+    nb_leaves = 0;
+    for(k = 0; k < nb_cur; k++){
+      rm[k] = (1 == anneal_crossings(work, wl, &cur[k]));
+      nb_leaves += rm[k];
+    }
+    nb_rm = 1 + rng_int(rn, ANNEAL_REMOVE);
+    if(nb_rm >= nb_cur) nb_rm = nb_cur - 1;
+    first = nb_cur;
+    for(k = 0; k < nb_cur; k++){
+      if(!rm[k]) continue;
+      rm[k] = (rng_int(rn, nb_leaves--) < nb_rm);
+      if(!rm[k]) continue;
+      nb_rm--;
+      if(first == nb_cur) first = k;
+    }
+    if(first == nb_cur) first = nb_cur - 1; // Nothing removed.
+
+    // Remove them: the words placed after the first one are rolled back,
+    // and the kept ones are added again.
+    nb_kept = 0;
+    for(k = first; k < nb_cur; k++)
+      if(!rm[k]) kept[nb_kept++] = cur[k];
+    cw_rollback(work, marks[first], &l);
+    res = anneal_add(work, wl, kept, nb_kept, marks, &l);
+
+    // Insert random words, from a subset of a large list, until the end of
+    // the time budget.
+    nb_sub = (NULL != ws) ? sampler_draw(ws, rn, drawn, subset) : nw;
+    for(j = 0, n = 0; (0 == res) && (j < ANNEAL_LOOP * nb_sub); j++){
+      if((0 == ++n % ANNEAL_CLOCK) && timer_expired(deadline)) break;
+      k = rng_int(rn, nb_sub);
+      if(NULL != ws) k = subset[k];
+      marks[work->nb_words] = cw_mark(work);
+      if((0 == work->used[k]) &&
+         (-1 == cw_add_crossing_word(work, wl, k, &l, rn)))
+        res = -1;
+    }
+    if(0 != res) break;
+
+    // Acceptance, or roll back of the step.
+    score = cw_score(work, sw);
+    if(score > score_best){
+      nb_best = work->nb_words;
+      memcpy(best, work->words, nb_best * sizeof(placed_word));
+      score_best = score;
+    }
+    if(score + threshold >= score_cur){
+      memcpy(cur + first, work->words + first,
+             (work->nb_words - first) * sizeof(placed_word));
+      nb_cur = work->nb_words;
+      score_cur = score;
+    }else{
+      cw_rollback(work, marks[first], &l);
+      res = anneal_add(work, wl, cur + first, nb_cur - first, marks, &l);
+    }
+
+    now = timer_now();
+  }
+
+  if(verbose)
+    fprintf(stderr, "Local search: %ld steps, %d -> %d words.\n", iter,
+                    cw->nb_words, nb_best);
+  if(0 == res){
+    cw_reset(cw);
+    l = 1;
+    for(k = 0; (0 == res) && (k < nb_best); k++)
+      res = cw_add_word(cw, wl, best[k].w, best[k].posx, best[k].posy,
+                        best[k].orient, &l);
+  }
+
+  cw_free(work);
+  arena_free(&mem);
+  return res;
+}
@@ -0,0 +1,57 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** anneal.h ****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of a local search improving a crossword within a time       *
+ *   budget: words are removed and others inserted, and the changes are     *
+ *   kept according to a threshold that decreases with time (a variant of   *
+ *   simulated annealing).                                                  *
+ ****************************************************************************/
+#ifndef __ANNEAL_H__
+#define __ANNEAL_H__
+
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "score.h"
+#include "sample.h"
+
+/*
+ * Improve a crossword by local search. At each step, one to ANNEAL_REMOVE
+ * leaf words (crossing a single word) are removed, and random words are then
+ * inserted as in cw_compute (ANNEAL_LOOP loops, over a subset drawn by the
+ * sampler for a large list). The clock is read at each step and during the
+ * insertions, so that the deadline is kept. The new crossword is kept
+ * if its score (see score.h) is not worse than the current one by more than
+ * a threshold, that decreases from the weight of two words to zero at the
+ * deadline. The best crossword seen is returned.
+ * cw       : the crossword (improved in place).
+ * wl       : the list of words.
+ * rn       : the random generator.
+ * deadline : the end of the search (see timer.h), nothing is done if there
+ *            is none.
+ * sw       : the weights of the score.
+ * ws       : the sampler of the list (see sample.h), NULL if the list is
+ *            small enough to be used as a whole.
+ * verbose  : if set to 1 verbose mode. 0 otherwise.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_anneal(crossword cw, word_list wl, rng* rn, long deadline,
+              score_weights* sw, word_sampler* ws, int verbose);
+
+#endif
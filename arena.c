@@ -0,0 +1,126 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** arena.c *****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "arena.h".                  *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+/*
+ * Round a size up to a multiple of ARENA_ALIGN.
+ */
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+/*
+ * Size of the header of a block (the memory of the block stays aligned).
+ */
+#define ARENA_HEADER ARENA_ROUND(sizeof(arena_block))
+
+/*
+ * Initialize an empty arena (no allocation).
+ * a          : the arena.
+ * block_size : minimal size of the blocks (ARENA_BLOCK if 0).
+ */
+void arena_init(arena* a, size_t block_size){
+  a->first = NULL;
+  a->cur = NULL;
+  a->block_size = (0 == block_size) ? ARENA_BLOCK : block_size;
+  a->reserved = 0;
+  a->used = 0;
+  a->peak = 0;
+}
+
+/*
+ * Allocate memory in an arena (aligned on ARENA_ALIGN).
+ * a    : the arena.
+ * size : the size of the memory.
+ * Returns the memory, NULL on failure.
+ */
+void* arena_alloc(arena* a, size_t size){
+  arena_block* b;
+  size_t bs;
+
+  size = (0 == size) ? ARENA_ALIGN : ARENA_ROUND(size);
+
+  // Look in the current block, then in the blocks kept by arena_reset.
+  while((NULL != a->cur) && (a->cur->size - a->cur->used < size) &&
+        (NULL != a->cur->next))
+    a->cur = a->cur->next;
+
+  // New block, after the last one.
+  if((NULL == a->cur) || (a->cur->size - a->cur->used < size)){
+    bs = (size > a->block_size) ? size : ARENA_ROUND(a->block_size);
+    if(NULL == (b = malloc(ARENA_HEADER + bs))) return NULL;
+    b->next = NULL;
+    b->size = bs;
+    b->used = 0;
+    if(NULL == a->cur) a->first = b;
+    else a->cur->next = b;
+    a->cur = b;
+    a->reserved += ARENA_HEADER + bs;
+  }
+
+  b = a->cur;
+  b->used += size;
+  a->used += size;
+  if(a->used > a->peak) a->peak = a->used;
+  return (char*) b + ARENA_HEADER + b->used - size;
+}
+
+/*
+ * Release all the memory given by an arena, but keep its blocks for the
+ * next allocations.
+ * a : the arena.
+ */
+void arena_reset(arena* a){
+  arena_block* b;
+
+  for(b = a->first; NULL != b; b = b->next) b->used = 0;
+  a->cur = a->first;
+  a->used = 0;
+}
+
+/*
+ * Free all the blocks of an arena (it can then be used again).
+ * a : the arena.
+ */
+void arena_free(arena* a){
+  arena_block* b;
+
+  while(NULL != (b = a->first)){
+    a->first = b->next;
+    free(b);
+  }
+  a->cur = NULL;
+  a->reserved = 0;
+  a->used = 0;
+  a->peak = 0;
+}
+
+/*
+ * Print the statistics of an arena.
+ * out  : the output.
+ * name : name of the arena.
+ * a    : the arena.
+ */
+void arena_print_stats(FILE* out, const char* name, arena* a){
+  fprintf(out, "Memory of the %s: %lu bytes reserved, %lu used (peak %lu).\n",
+          name, (unsigned long) a->reserved, (unsigned long) a->used,
+          (unsigned long) a->peak);
+}
@@ -0,0 +1,96 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** arena.h *****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of a bump allocator (arena). Memory is taken from large     *
+ *   blocks and released all at once, and an arena can be reset to be       *
+ *   reused without giving its blocks back.                                 *
+ ****************************************************************************/
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * Alignment of the allocations (enough for any type of the program).
+ */
+#define ARENA_ALIGN 16
+
+/*
+ * Default minimal size of the blocks of an arena.
+ */
+#define ARENA_BLOCK (1 << 16)
+
+/*
+ * Header of a block of an arena (the memory follows it).
+ */
+typedef struct __arena_block__{
+  struct __arena_block__* next;  // Next block.
+  size_t size;           // Size of the memory of the block.
+  size_t used;           // Memory used in the block.
+}arena_block;
+
+/*
+ * Structure representing an arena (not thread safe).
+ */
+typedef struct __arena__{
+  arena_block* first;    // First block, NULL if none.
+  arena_block* cur;      // Block in which allocations are done.
+  size_t block_size;     // Minimal size of a new block.
+  size_t reserved;       // Memory taken from malloc (headers included).
+  size_t used;           // Memory given by arena_alloc since the last reset.
+  size_t peak;           // Maximal value of used.
+}arena;
+
+/*
+ * Initialize an empty arena (no allocation).
+ * a          : the arena.
+ * block_size : minimal size of the blocks (ARENA_BLOCK if 0).
+ */
+void arena_init(arena* a, size_t block_size);
+
+/*
+ * Allocate memory in an arena (aligned on ARENA_ALIGN).
+ * a    : the arena.
+ * size : the size of the memory.
+ * Returns the memory, NULL on failure.
+ */
+void* arena_alloc(arena* a, size_t size);
+
+/*
+ * Release all the memory given by an arena, but keep its blocks for the
+ * next allocations.
+ * a : the arena.
+ */
+void arena_reset(arena* a);
+
+/*
+ * Free all the blocks of an arena (it can then be used again).
+ * a : the arena.
+ */
+void arena_free(arena* a);
+
+/*
+ * Print the statistics of an arena.
+ * out  : the output.
+ * name : name of the arena.
+ * a    : the arena.
+ */
+void arena_print_stats(FILE* out, const char* name, arena* a);
+
+#endif
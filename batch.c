@@ -0,0 +1,321 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** batch.c *****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "batch.h".                  *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "gen.h"
+#include "timer.h"
+#include "buffer.h"
+#include "output.h"
+#include "batch.h"
+
+/*
+ * Maximal length of a line of a manifest.
+ */
+#define BATCH_LINE 256
+
+/*
+ * State shared by the workers of a batch.
+ */
+typedef struct __batch_shared__{
+  pthread_mutex_t lock;  // Protects all the fields below.
+  pthread_cond_t turn;   // Signaled when next_out changes.
+  word_list wl;          // The list of words.
+  batch_params* b;       // The parameters.
+  int next_job;          // Next crossword to be generated.
+  int next_out;          // Next crossword to be printed.
+  int error;             // Set to 1 if a worker failed.
+}batch_shared;
+
+/*
+ * Build the jobs of a batch of crosswords of the same size.
+ * jobs : the jobs (result, to be freed).
+ * nb   : the number of crosswords.
+ * w    : the width of the crosswords.
+ * h    : the height of the crosswords.
+ * seed : the seed of the first crossword.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int batch_jobs(batch_job** jobs, int nb, int w, int h, uint64_t seed){
+  int i;
+
+  if(NULL == (*jobs = malloc(nb * sizeof(batch_job)))){
+    fprintf(stderr, "Malloc error in batch_jobs !\n");
+    return -1;
+  }
+  for(i = 0; i < nb; i++){
+    (*jobs)[i].width = w;
+    (*jobs)[i].height = h;
+    (*jobs)[i].seed = seed + i;
+  }
+  return 0;
+}
+
+/*
+ * Read the size and the seed of a crossword on a line of a manifest.
+ * s    : the line.
+ * job  : the job (result).
+ * seed : the seed of the crossword if the line has none.
+ * Returns 1 if a job was read, 0 if the line is empty, -1 if it is
+ * malformed.
+ */
+static int batch_read_line(char* s, batch_job* job, uint64_t seed){
+  char* end;
+  long w, h;
+
+  while((' ' == *s) || ('\t' == *s)) s++;
+  if(('\0' == *s) || ('\n' == *s) || ('\r' == *s) || ('#' == *s)) return 0;
+
+  w = strtol(s, &end, 10);
+  if(end == s) return -1;
+  h = strtol(s = end, &end, 10);
+  if(end == s) return -1;
+  job->seed = strtoull(s = end, &end, 10);
+  if(end == s) job->seed = seed;
+  while((' ' == *end) || ('\t' == *end) || ('\r' == *end)) end++;
+  if(('\0' != *end) && ('\n' != *end)) return -1;
+
+  if((w < MIN_SIZE) || (w > MAX_SIZE) || (h < MIN_SIZE) || (h > MAX_SIZE))
+    return -1;
+  job->width = (int) w;
+  job->height = (int) h;
+  return 1;
+}
+
+/*
+ * Read the jobs of a batch from a manifest.
+ * f    : the manifest.
+ * jobs : the jobs (result, to be freed).
+ * nb   : the number of jobs (result).
+ * seed : the seed of the first crossword, for the lines without one.
+ * Returns 0 if all went well, -1 otherwise (an error is printed).
+ */
+int batch_read_manifest(FILE* f, batch_job** jobs, int* nb, uint64_t seed){
+  char line[BATCH_LINE];
+  batch_job* tmp;
+  int size = 64;
+  int nl = 0;
+  int res;
+
+  *nb = 0;
+  if(NULL == (*jobs = malloc(size * sizeof(batch_job)))){
+    fprintf(stderr, "Malloc error in batch_read_manifest !\n");
+    return -1;
+  }
+
+  while(NULL != fgets(line, BATCH_LINE, f)){
+    nl++;
+    if((NULL == strchr(line, '\n')) && !feof(f)){
+      fprintf(stderr, "Manifest error, at line %i... (line too long)\n", nl);
+      free(*jobs);
+      return -1;
+    }
+
+    if(*nb == size){
+      if(NULL == (tmp = realloc(*jobs, 2 * size * sizeof(batch_job)))){
+        fprintf(stderr, "Malloc error in batch_read_manifest !\n");
+        free(*jobs);
+        return -1;
+      }
+      *jobs = tmp;
+      size *= 2;
+    }
+
+    res = batch_read_line(line, &(*jobs)[*nb], seed + *nb);
+    if(-1 == res){
+      fprintf(stderr, "Manifest error, at line %i... (expected width height "
+                      "[seed], sizes between %i and %i)\n",
+                      nl, MIN_SIZE, MAX_SIZE);
+      free(*jobs);
+      return -1;
+    }
+    *nb += res;
+  }
+
+  if(0 == *nb){
+    fprintf(stderr, "Manifest error, no crossword...\n");
+    free(*jobs);
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * Print a rendered crossword of a batch in its own file.
+ * b   : the parameters of the batch.
+ * k   : the index of the crossword.
+ * out : the rendered crossword.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+static int batch_print_file(batch_params* b, int k, buffer* out){
+  const char* ext = output_backends[b->format].ext;
+  char* name;
+  FILE* f;
+  int size = strlen(b->prefix) + 16;
+  int res;
+
+  if(NULL == (name = malloc(size))){
+    fprintf(stderr, "Malloc error in batch_print_file !\n");
+    return -1;
+  }
+  snprintf(name, size, "%s%04d%s", b->prefix, k + 1, ext);
+  if(NULL == (f = fopen(name, "w"))){
+    fprintf(stderr, "Cannot open the output file %s...\n", name);
+    free(name);
+    return -1;
+  }
+  res = buf_write(out, f);
+  if(0 != fclose(f)) res = -1;
+  if(0 != res) fprintf(stderr, "Error while writing %s !\n", name);
+  free(name);
+  return res;
+}
+
+/*
+ * Worker: generates crosswords until there is none left. The crosswords
+ * are rendered in memory, then printed in order: a worker waits for the
+ * previous crosswords to be printed before writing its own (in its own
+ * file, the wait is only for the verbose messages).
+ * arg : the shared state (batch_shared*).
+ * Returns NULL.
+ */
+static void* batch_worker(void* arg){
+  batch_shared* s = (batch_shared*) arg;
+  batch_params* b = s->b;
+  crossword cw;
+  gen_params p;
+  buffer out;
+  int k, res;
+
+  buf_init(&out);
+
+  while(1){
+    // Take the next crossword.
+    pthread_mutex_lock(&s->lock);
+    k = s->next_job;
+    if(s->error || k >= b->nb_jobs){
+      pthread_mutex_unlock(&s->lock);
+      break;
+    }
+    s->next_job++;
+    pthread_mutex_unlock(&s->lock);
+
+    // Generation, with the runs on this thread.
+    p = b->gen;
+    p.width = b->jobs[k].width;
+    p.height = b->jobs[k].height;
+    p.seed = b->jobs[k].seed;
+    p.nb_threads = 1;
+    p.verbose = 0;
+    cw = NULL;
+    res = cw_generate(&cw, s->wl, &p);
+    if(0 != res) fprintf(stderr, "Error while computing the crossword !\n");
+    buf_reset(&out);
+    if(0 == res) res = cw_render_format(&out, cw, s->wl, b->format);
+    if((0 == res) && (NULL != b->prefix))
+      res = batch_print_file(b, k, &out);
+
+    // Printing, in order.
+    pthread_mutex_lock(&s->lock);
+    while(s->next_out != k) pthread_cond_wait(&s->turn, &s->lock);
+    if((0 == res) && (NULL == b->prefix) &&
+       (0 != (res = buf_write(&out, stdout))))
+      fprintf(stderr, "Error while printing the crossword !\n");
+    if(0 != res) s->error = 1;
+    else if(b->verbose)
+      fprintf(stderr, "Crossword %d (seed %llu): %d/%d words placed.\n",
+                      k + 1, (unsigned long long) p.seed, cw->nb_words,
+                      s->wl->next_free);
+    s->next_out++;
+    pthread_cond_broadcast(&s->turn);
+    pthread_mutex_unlock(&s->lock);
+
+    if(NULL != cw) cw_free(cw);
+  }
+  buf_free(&out);
+  return NULL;
+}
+
+/*
+ * Generate the crosswords of a batch.
+ * wl : the list of words.
+ * b  : the parameters of the batch.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int cw_batch(word_list wl, batch_params* b){
+  batch_shared s;
+  pthread_t* th = NULL;
+  int nb_th = b->nb_threads;
+  long start = timer_now();
+  long ms;
+  int i;
+
+  s.wl = wl;
+  s.b = b;
+  s.next_job = 0;
+  s.next_out = 0;
+  s.error = 0;
+  if(0 != pthread_mutex_init(&s.lock, NULL)){
+    fprintf(stderr, "Mutex initialization error in cw_batch !\n");
+    return -1;
+  }
+  if(0 != pthread_cond_init(&s.turn, NULL)){
+    fprintf(stderr, "Condition initialization error in cw_batch !\n");
+    pthread_mutex_destroy(&s.lock);
+    return -1;
+  }
+
+  if(nb_th > b->nb_jobs) nb_th = b->nb_jobs;
+  if(nb_th < 1) nb_th = 1;
+
+  // The calling thread is the first worker.
+  if(nb_th > 1){
+    if(NULL == (th = malloc((nb_th - 1) * sizeof(pthread_t)))){
+      fprintf(stderr, "Malloc error in cw_batch !\n");
+      pthread_cond_destroy(&s.turn);
+      pthread_mutex_destroy(&s.lock);
+      return -1;
+    }
+    for(i = 0; i < nb_th - 1; i++){
+      if(0 != pthread_create(&th[i], NULL, batch_worker, &s)){
+        fprintf(stderr, "Thread creation error in cw_batch !\n");
+        nb_th = i + 1;
+        break;
+      }
+    }
+  }
+  batch_worker(&s);
+  for(i = 0; i < nb_th - 1; i++) pthread_join(th[i], NULL);
+  free(th);
+  pthread_cond_destroy(&s.turn);
+  pthread_mutex_destroy(&s.lock);
+
+  if(b->verbose && !s.error){
+    ms = timer_now() - start;
+    fprintf(stderr, "%d crosswords in %ld ms (%ld per second).\n",
+                    b->nb_jobs, ms, (ms > 0) ? 1000L * b->nb_jobs / ms : 0);
+  }
+  return s.error ? -1 : 0;
+}
@@ -0,0 +1,92 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** batch.h *****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the batch mode: many crosswords are generated from a     *
+ *   single list of words, in parallel, and printed to their own files or   *
+ *   to a single stream.                                                    *
+ ****************************************************************************/
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "const.h"
+#include "word.h"
+#include "gen.h"
+
+/*
+ * A crossword of a batch.
+ */
+typedef struct __batch_job__{
+  int width;             // Width of the crossword.
+  int height;            // Height of the crossword.
+  uint64_t seed;         // Seed of the generation.
+}batch_job;
+
+/*
+ * Parameters of a batch.
+ */
+typedef struct __batch_params__{
+  batch_job* jobs;       // The crosswords to generate.
+  int nb_jobs;           // Number of crosswords.
+  gen_params gen;        // Parameters of the generations (the size and the
+                         // seed are the ones of the jobs).
+  int nb_threads;        // Number of crosswords generated in parallel.
+  int format;            // Output format (see output.h).
+  const char* prefix;    // Prefix of the output files, NULL if all the
+                         // crosswords are printed on the standard output.
+  int verbose;           // If set to 1 verbose mode. 0 otherwise.
+}batch_params;
+
+/*
+ * Build the jobs of a batch of crosswords of the same size, the seed of the
+ * i-th crossword being seed + i.
+ * jobs : the jobs (result, to be freed).
+ * nb   : the number of crosswords.
+ * w    : the width of the crosswords.
+ * h    : the height of the crosswords.
+ * seed : the seed of the first crossword.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int batch_jobs(batch_job** jobs, int nb, int w, int h, uint64_t seed);
+
+/*
+ * Read the jobs of a batch from a manifest: one crossword per line, given
+ * by its width, its height and optionally its seed (seed + i for the i-th
+ * crossword if none). Empty lines and lines starting with '#' are skipped.
+ * f    : the manifest.
+ * jobs : the jobs (result, to be freed).
+ * nb   : the number of jobs (result).
+ * seed : the seed of the first crossword, for the lines without one.
+ * Returns 0 if all went well, -1 otherwise (an error is printed).
+ */
+int batch_read_manifest(FILE* f, batch_job** jobs, int* nb, uint64_t seed);
+
+/*
+ * Generate the crosswords of a batch, b->nb_threads at a time (each of them
+ * on a single thread). The crosswords are printed in the order of the jobs,
+ * on the standard output or in the files prefix0001.txt, prefix0002.txt...
+ * (the extension depends on the format, see output_backends). A crossword
+ * does not depend on the number of threads (see cw_generate).
+ * wl : the list of words.
+ * b  : the parameters of the batch.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int cw_batch(word_list wl, batch_params* b);
+
+#endif
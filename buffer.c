@@ -0,0 +1,178 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** buffer.c ****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "buffer.h".                 *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "buffer.h"
+
+/*
+ * Make room for n more bytes in a buffer (the size is at least doubled).
+ * b : the buffer.
+ * n : the number of bytes.
+ * Returns 0 if all went well, -1 otherwise (the error is remembered).
+ */
+static int buf_grow(buffer* b, size_t n){
+  size_t size = (0 == b->size) ? BUFFER_INIT : b->size;
+  char* data;
+
+  if(b->error) return -1;
+  if(b->len + n <= b->size) return 0;
+  while(size < b->len + n) size *= 2;
+  if(NULL == (data = realloc(b->data, size))){
+    fprintf(stderr, "Realloc error in buf_grow !\n");
+    b->error = 1;
+    return -1;
+  }
+  b->data = data;
+  b->size = size;
+  return 0;
+}
+
+/*
+ * Initialize an empty buffer (no allocation).
+ * b : the buffer.
+ */
+void buf_init(buffer* b){
+  b->data = NULL;
+  b->len = 0;
+  b->size = 0;
+  b->error = 0;
+}
+
+/*
+ * Empty a buffer, but keep its memory for the next appends.
+ * b : the buffer.
+ */
+void buf_reset(buffer* b){
+  b->len = 0;
+  b->error = 0;
+}
+
+/*
+ * Free the memory of a buffer (it can then be used again).
+ * b : the buffer.
+ */
+void buf_free(buffer* b){
+  free(b->data);
+  buf_init(b);
+}
+
+/*
+ * Append bytes to a buffer.
+ * b : the buffer.
+ * s : the bytes.
+ * n : the number of bytes.
+ */
+void buf_add(buffer* b, const char* s, size_t n){
+  if(0 != buf_grow(b, n)) return;
+  memcpy(b->data + b->len, s, n);
+  b->len += n;
+}
+
+/*
+ * Append a string to a buffer.
+ * b : the buffer.
+ * s : the string.
+ */
+void buf_puts(buffer* b, const char* s){
+  buf_add(b, s, strlen(s));
+}
+
+/*
+ * Append a char to a buffer.
+ * b : the buffer.
+ * c : the char.
+ */
+void buf_putc(buffer* b, char c){
+  if((b->len == b->size) && (0 != buf_grow(b, 1))) return;
+  b->data[b->len++] = c;
+}
+
+/*
+ * Append a char several times to a buffer.
+ * b : the buffer.
+ * c : the char.
+ * n : the number of times (nothing is done if n <= 0).
+ */
+void buf_fill(buffer* b, char c, int n){
+  if((n <= 0) || (0 != buf_grow(b, n))) return;
+  memset(b->data + b->len, c, n);
+  b->len += n;
+}
+
+/*
+ * Append an integer, in decimal, to a buffer.
+ * b : the buffer.
+ * n : the integer.
+ */
+void buf_int(buffer* b, long n){
+  char tmp[24];
+  unsigned long u = (n < 0) ? -(unsigned long) n : (unsigned long) n;
+  int i = sizeof(tmp);
+
+  // Digits from the end of tmp.
+  do{
+    tmp[--i] = '0' + (u % 10);
+    u /= 10;
+  }while(0 != u);
+  if(n < 0) tmp[--i] = '-';
+  buf_add(b, tmp + i, sizeof(tmp) - i);
+}
+
+/*
+ * Append formatted text to a buffer (as printf).
+ * b   : the buffer.
+ * fmt : the format.
+ */
+void buf_printf(buffer* b, const char* fmt, ...){
+  va_list ap;
+  int n;
+
+  // First try in the free memory, then with the exact size.
+  if(0 != buf_grow(b, 64)) return;
+  va_start(ap, fmt);
+  n = vsnprintf(b->data + b->len, b->size - b->len, fmt, ap);
+  va_end(ap);
+  if(n < 0){
+    b->error = 1;
+    return;
+  }
+  if((size_t) n >= b->size - b->len){
+    if(0 != buf_grow(b, n + 1)) return;
+    va_start(ap, fmt);
+    vsnprintf(b->data + b->len, b->size - b->len, fmt, ap);
+    va_end(ap);
+  }
+  b->len += n;
+}
+
+/*
+ * Write the content of a buffer to a file (with a single fwrite).
+ * b : the buffer.
+ * f : the file.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int buf_write(buffer* b, FILE* f){
+  if(b->error) return -1;
+  if((b->len > 0) && (b->len != fwrite(b->data, 1, b->len, f))) return -1;
+  return 0;
+}
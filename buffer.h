@@ -0,0 +1,117 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** buffer.h ****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of a growable output buffer. A document is built in memory  *
+ *   with bulk appends, then written at once to a file, or used as is (e.g. *
+ *   to know its size before sending it).                                   *
+ ****************************************************************************/
+#ifndef __BUFFER_H__
+#define __BUFFER_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * Initial size of the memory of a buffer.
+ */
+#define BUFFER_INIT 4096
+
+/*
+ * Structure representing an output buffer (not thread safe). An allocation
+ * failure is remembered: the following appends are ignored and the buffer
+ * cannot be written.
+ */
+typedef struct __buffer__{
+  char* data;            // The content (not terminated by a null char).
+  size_t len;            // Length of the content.
+  size_t size;           // Size of the memory of data.
+  int error;             // Set to 1 if an allocation failed.
+}buffer;
+
+/*
+ * Initialize an empty buffer (no allocation).
+ * b : the buffer.
+ */
+void buf_init(buffer* b);
+
+/*
+ * Empty a buffer, but keep its memory for the next appends.
+ * b : the buffer.
+ */
+void buf_reset(buffer* b);
+
+/*
+ * Free the memory of a buffer (it can then be used again).
+ * b : the buffer.
+ */
+void buf_free(buffer* b);
+
+/*
+ * Append bytes to a buffer.
+ * b : the buffer.
+ * s : the bytes.
+ * n : the number of bytes.
+ */
+void buf_add(buffer* b, const char* s, size_t n);
+
+/*
+ * Append a string to a buffer.
+ * b : the buffer.
+ * s : the string.
+ */
+void buf_puts(buffer* b, const char* s);
+
+/*
+ * Append a char to a buffer.
+ * b : the buffer.
+ * c : the char.
+ */
+void buf_putc(buffer* b, char c);
+
+/*
+ * Append a char several times to a buffer.
+ * b : the buffer.
+ * c : the char.
+ * n : the number of times (nothing is done if n <= 0).
+ */
+void buf_fill(buffer* b, char c, int n);
+
+/*
+ * Append an integer, in decimal, to a buffer.
+ * b : the buffer.
+ * n : the integer.
+ */
+void buf_int(buffer* b, long n);
+
+/*
+ * Append formatted text to a buffer (as printf).
+ * b   : the buffer.
+ * fmt : the format.
+ */
+void buf_printf(buffer* b, const char* fmt, ...)
+  __attribute__((format(printf, 2, 3)));
+
+/*
+ * Write the content of a buffer to a file (with a single fwrite).
+ * b : the buffer.
+ * f : the file.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int buf_write(buffer* b, FILE* f);
+
+#endif
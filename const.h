@@ -19,8 +19,8 @@
  * Content of this file:                                                    *
  *   Definition of constants that can be altered to change the behaviour of *
  *   the crossword generator. In particular the maximum length of a word,   *
- *   and the maximum length of the clue associated to a word can be changed *
- *   here.                                                                  *
+ *   and the minimum length of the clue associated to a word can be changed *
+ *   here (clues are not limited in length).                                *
  * Author: Rodolphe Lepigre <rlepigre@gmail.com>                            *
  ****************************************************************************/
 #ifndef __CONST_H__
@@ -29,7 +29,6 @@
 // Words, clues
 #define MAX_WORD_SIZE 14   // Max size of a word.
 #define MIN_WORD_SIZE 1    // Min size of a word.
-#define MAX_DEF_SIZE 200   // Max size of the clue.
 #define MIN_DEF_SIZE 1     // Min size of the clue.
 #define INIT_NB 8          // Size of the word buffer at first (8 is fine).
 
@@ -43,7 +42,17 @@
 
 // Algorithm
 #define NB_LOOP 20         // Number of loops for looking for words to place.
-#define NB_RAND_CH 12      // Maximum number of random choice for insertion.
+#define NB_FAIL 1000       // Words not placed in a row ending a run.
 #define NB_RUN 1000        // Number of time to run the algorithm. Keep best.
+#define MAX_THREADS 64     // Max number of threads running the algorithm.
+#define SEARCH_NODES 500   // Max number of nodes of a search (see search.h).
+#define SEARCH_BRANCH 8    // Max number of positions tried for a word.
+#define ANNEAL_MS 200      // Time of the local search (see anneal.h).
+#define ANNEAL_REMOVE 6    // Max number of words removed by a local step.
+#define ANNEAL_LOOP 2      // Number of loops inserting words in a step.
+#define SAMPLE_PER_CELL 8  // Words drawn per cell of the grid (see sample.h).
+#define SERVE_QUEUE 16     // Connections waiting for a worker (see serve.h).
+#define SERVE_MS 10000     // Max time of a request, in milliseconds.
+#define SERVE_IDLE 30      // Seconds a connection can stay idle.
 
 #endif
@@ -25,56 +25,131 @@
 #include <string.h>
 #include "cw.h"
 #include "const.h"
+#include "timer.h"
+#include "match.h"
+
+/*
+ * Number of words tried by cw_compute_among between two readings of the
+ * clock.
+ */
+#define CW_CLOCK 64
+
+/*
+ * Record a change of a crossword in its journal, if it is journaled. On
+ * failure the journal_error flag is set.
+ * cw   : the crossword.
+ * kind : the array changed (CW_GRID, ...).
+ * pos  : the index of the change in the array.
+ * old  : the value before the change.
+ */
+static void cw_log(crossword cw, int kind, int pos, int old){
+  cw_change* tmp;
+
+  if(NULL == cw->journal) return;
+  if(cw->nb_changes == cw->size_journal){
+    tmp = realloc(cw->journal, 2 * cw->size_journal * sizeof(cw_change));
+    if(NULL == tmp){
+      fprintf(stderr, "Malloc error in cw_log !\n");
+      cw->journal_error = 1;
+      return;
+    }
+    cw->journal = tmp;
+    cw->size_journal *= 2;
+  }
+  cw->journal[cw->nb_changes].kind = kind;
+  cw->journal[cw->nb_changes].pos = pos;
+  cw->journal[cw->nb_changes].old = old;
+  cw->nb_changes++;
+}
 
 /*
  * Initialize a crossword.
  * cw : the crossword.
  * w  : the width of the crossword.
  * h  : the height of the crossword.
+ * nw : the number of words in the list the crossword is built from.
  * Returns 0 if all went well, -1 otherwise.
  */
-int cw_init(crossword* cw, int w, int h){
-  int i, j;
+int cw_init(crossword* cw, int w, int h, int nw){
+  int size = (w + 2) * (h + 2);
+  int nwa = (nw > 0) ? nw : 1;
+  arena mem;
 
-  if(NULL == ((*cw) = malloc(sizeof(struct __crossword__)))){
+  // Everything (the structure included) fits in a single block. There is
+  // a slack at the end of the grids: a slot is read on WORD_STORAGE bytes.
+  arena_init(&mem, sizeof(struct __crossword__) + 2 * (size + WORD_STORAGE) +
+                   2 * size * sizeof(int) + nwa * sizeof(placed_word) + nwa +
+                   8 * ARENA_ALIGN);
+  if((NULL == (*cw = arena_alloc(&mem, sizeof(struct __crossword__)))) ||
+     (NULL == ((*cw)->grid = arena_alloc(&mem, size + WORD_STORAGE))) ||
+     (NULL == ((*cw)->tgrid = arena_alloc(&mem, size + WORD_STORAGE))) ||
+     (NULL == ((*cw)->labels = arena_alloc(&mem, size * sizeof(int)))) ||
+     (NULL == ((*cw)->words = arena_alloc(&mem, nwa * sizeof(placed_word)))) ||
+     (NULL == ((*cw)->used = arena_alloc(&mem, nwa * sizeof(char)))) ||
+     (NULL == ((*cw)->open_next = arena_alloc(&mem, size * sizeof(int))))){
     fprintf(stderr, "Malloc error in cw_init !\n");
+    arena_free(&mem);
     return -1;
   }
 
   (*cw)->width = w;
   (*cw)->height = h;
-  if(NULL == ((*cw)->grid = malloc((*cw)->width * sizeof(char*)))){
-    fprintf(stderr, "Malloc error in cw_init !\n");
-    return -1;
-  }
-  for(i = 0; i < (*cw)->width; i++){
-    if(NULL == ((*cw)->grid[i] = malloc((*cw)->height * sizeof(char)))){
-      fprintf(stderr, "Malloc error in cw_init !\n");
-      return -1;
-    }
-  }
-  for(i = 0; i < (*cw)->width; i++)
-    for(j = 0; j < (*cw)->height; j++)
-      (*cw)->grid[i][j] = EMPTY_CHAR;
-  if(NULL == ((*cw)->words = malloc(INIT_NB * sizeof(placed_word)))){
-    fprintf(stderr, "Malloc error in cw_init !\n");
-    return -1;
-  }
+  (*cw)->stride = w + 2;
+  memset((*cw)->labels, -1, size * sizeof(int));
+  // A word of the list is placed at most once.
+  (*cw)->size_wlist = nw;
+  (*cw)->nb_used = nw;
+  memset((*cw)->used, 0, nw);
   (*cw)->nb_words = 0;
-  (*cw)->size_wlist = INIT_NB;
+  (*cw)->journal = NULL;
+  (*cw)->nb_changes = 0;
+  (*cw)->size_journal = 0;
+  (*cw)->journal_error = 0;
+  (*cw)->mem = mem;
+  cw_reset(*cw);
   return 0;
 }
 
+/*
+ * Empty a crossword, so that it can be computed again (no allocation).
+ * cw : the crossword.
+ */
+void cw_reset(crossword cw){
+  int size = cw->stride * (cw->height + 2);
+  int i;
+
+  memset(cw->grid, EMPTY_CHAR, size + WORD_STORAGE);
+  memset(cw->tgrid, EMPTY_CHAR, size + WORD_STORAGE);
+  memset(cw->rows, 0, sizeof(cw->rows));
+  memset(cw->cols, 0, sizeof(cw->cols));
+  memset(cw->hblock, 0, sizeof(cw->hblock));
+  memset(cw->vblock, 0, sizeof(cw->vblock));
+  for(i = 0; i < cw->nb_words; i++){
+    cw->used[cw->words[i].w] = 0;
+    CW_LABEL(cw, cw->words[i].posx, cw->words[i].posy) = -1;
+  }
+  memset(cw->open_head, -1, sizeof(cw->open_head));
+  cw->open_letters = 0;
+  cw->nb_words = 0;
+  cw->nb_cross = 0;
+  cw->nb_cells = 0;
+  cw->xmin = cw->width;
+  cw->ymin = cw->height;
+  cw->xmax = -1;
+  cw->ymax = -1;
+  cw->nb_changes = 0;
+}
+
 /*
  * Free the memory allocated to a crossword.
  * cw : the crossword.
  */
 void cw_free(crossword cw){
-  int i;
-  for(i = 0; i < cw->width; i++) free(cw->grid[i]);
-  free(cw->grid);
-  free(cw->words);
-  free(cw);
+  // The arena is in its own memory.
+  arena mem = cw->mem;
+
+  free(cw->journal);
+  arena_free(&mem);
 }
 
 /*
@@ -90,56 +165,217 @@ void cw_free(crossword cw){
  */
 int cw_add_word(crossword cw, word_list wl,
                 int i, int x, int y, int or, int* l){
-  int j, k;
-  placed_word* wltmp = NULL;
+  int j, k, t;
+  int cross = 0;
+  int c = CW_POS(cw, x, y);
+  int step = (or == HORIZONTAL) ? 1 : cw->stride;
+  int len = wl->l[i].len;
+  uint32_t span;
+
+  // We verify that there is enough space in the list.
+  if(cw->nb_words >= cw->size_wlist){
+    fprintf(stderr, "Too many words in cw_add_word !\n");
+    return -1;
+  }
 
   // The word is now used.
-  cw->words[cw->nb_words].w = wl->l[i];
-  wl->l[i].used = 1;
+  cw->words[cw->nb_words].w = i;
+  cw_log(cw, CW_USED, i, cw->used[i]);
+  cw->used[i] = 1;
 
   // Orientation and position.
   cw->words[cw->nb_words].orient = or;
   cw->words[cw->nb_words].posx = x;
   cw->words[cw->nb_words].posy = y;
 
-  // Label. Chech first if there is not a label already ar the position.
-  k = -1;
-  for(j = 0; j < cw->nb_words; j++)
-    if((cw->words[j].posx == x) && (cw->words[j].posy == y))
-      k = j;
-  if(-1 == k){
-    cw->words[cw->nb_words].label = *l;
+  // Label. A word starting at the same position already has one.
+  if(-1 == cw->labels[c]){
+    cw_log(cw, CW_LABELS, c, -1);
+    cw->labels[c] = *l;
     (*l)++;
-  }else{
-    cw->words[cw->nb_words].label = cw->words[k].label;
   }
+  cw->words[cw->nb_words].label = cw->labels[c];
   
-  // Add the word to the grid. 
+  // Add the word to the grid, the new cells can now be crossed.
+  for(k = 0; k < len; k++, c += step){
+    if(or == HORIZONTAL){
+      t = CW_TPOS(cw, x + k, y);
+      j = (cw->cols[x + k + 1] >> (y + 1)) & 1;
+    }else{
+      t = CW_TPOS(cw, x, y + k);
+      j = (cw->rows[y + k + 1] >> (x + 1)) & 1;
+    }
+    if(0 == j){
+      cw_log(cw, CW_GRID, c, cw->grid[c]);
+      cw_log(cw, CW_TGRID, t, cw->tgrid[t]);
+      cw->grid[c] = wl->l[i].w[k];
+      cw->tgrid[t] = wl->l[i].w[k];
+      j = (unsigned char) wl->l[i].w[k];
+      cw_log(cw, CW_OPEN_NEXT, c, cw->open_next[c]);
+      cw_log(cw, CW_OPEN_HEAD, j, cw->open_head[j]);
+      cw->open_next[c] = cw->open_head[j];
+      cw->open_head[j] = c;
+      cw->open_letters |= WORD_LETTER(j);
+    }else{
+      cross++;
+    }
+  }
+
+  // Update the bitboards.
+  if(or == HORIZONTAL){
+    span = CW_BITS(len) << (x + 1);
+    cw_log(cw, CW_ROWS, y + 1, cw->rows[y + 1]);
+    cw_log(cw, CW_HBLOCK, y + 1, cw->hblock[y + 1]);
+    cw->rows[y + 1] |= span;
+    cw->hblock[y + 1] |= span;
+    for(k = 0; k < len; k++){
+      cw_log(cw, CW_COLS, x + k + 1, cw->cols[x + k + 1]);
+      cw->cols[x + k + 1] |= ((uint32_t) 1) << (y + 1);
+    }
+  }else{
+    span = CW_BITS(len) << (y + 1);
+    cw_log(cw, CW_COLS, x + 1, cw->cols[x + 1]);
+    cw_log(cw, CW_VBLOCK, x + 1, cw->vblock[x + 1]);
+    cw->cols[x + 1] |= span;
+    cw->vblock[x + 1] |= span;
+    for(k = 0; k < len; k++){
+      cw_log(cw, CW_ROWS, y + k + 1, cw->rows[y + k + 1]);
+      cw->rows[y + k + 1] |= ((uint32_t) 1) << (x + 1);
+    }
+  }
+
+  // Update the statistics (see score.h).
+  cw_log(cw, CW_NB_CROSS, 0, cw->nb_cross);
+  cw_log(cw, CW_NB_CELLS, 0, cw->nb_cells);
+  cw->nb_cross += cross;
+  cw->nb_cells += len - cross;
   if(or == HORIZONTAL){
-    for(k = x; k < (int) (x + strlen(wl->l[i].w)); k++)
-      cw->grid[k][y] = wl->l[i].w[k - x];
+    j = x + len - 1;
+    k = y;
   }else{
-    for(k = y; k < (int) (y + strlen(wl->l[i].w)); k++)
-       cw->grid[x][k] = wl->l[i].w[k - y];
+    j = x;
+    k = y + len - 1;
+  }
+  if(x < cw->xmin){
+    cw_log(cw, CW_XMIN, 0, cw->xmin);
+    cw->xmin = x;
+  }
+  if(y < cw->ymin){
+    cw_log(cw, CW_YMIN, 0, cw->ymin);
+    cw->ymin = y;
+  }
+  if(j > cw->xmax){
+    cw_log(cw, CW_XMAX, 0, cw->xmax);
+    cw->xmax = j;
+  }
+  if(k > cw->ymax){
+    cw_log(cw, CW_YMAX, 0, cw->ymax);
+    cw->ymax = k;
   }
 
   // A new word has bee added.
+  cw_log(cw, CW_NB_WORDS, 0, cw->nb_words);
   cw->nb_words++;
 
-  // We verify that there is enough space in the list.
-  if(cw->nb_words >= cw->size_wlist){
-    cw->size_wlist *= 2;
-    wltmp = realloc(cw->words, cw->size_wlist * sizeof(placed_word));
-    if(NULL == wltmp){
-      fprintf(stderr, "Realloc error in cw_compute !\n");
-      return -1;
-    }
-    cw->words = wltmp;
-  }
+  return cw->journal_error ? -1 : 0;
+}
 
+/*
+ * Start journaling the changes of a crossword (see cw_mark).
+ * cw : the crossword.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int cw_journal_init(crossword cw){
+  if(NULL != cw->journal) return 0;
+  cw->size_journal = 64 * (MAX_WORD_SIZE + 1);
+  cw->journal = malloc(cw->size_journal * sizeof(cw_change));
+  if(NULL == cw->journal){
+    fprintf(stderr, "Malloc error in cw_journal_init !\n");
+    return -1;
+  }
+  cw->nb_changes = 0;
+  cw->journal_error = 0;
   return 0;
 }
 
+/*
+ * Position in the journal of a crossword, to roll back to (see cw_rollback).
+ * cw : the crossword (journaled, see cw_journal_init).
+ * Returns the mark.
+ */
+int cw_mark(crossword cw){
+  return cw->nb_changes;
+}
+
+/*
+ * Undo the changes of a crossword done after a mark, in reverse order. The
+ * open letters are not restored (it is only a filter, see cw.h).
+ * cw   : the crossword (journaled, see cw_journal_init).
+ * mark : the mark (see cw_mark).
+ * l    : label (the labels given since the mark are given back).
+ */
+void cw_rollback(crossword cw, int mark, int* l){
+  cw_change* ch;
+
+  while(cw->nb_changes > mark){
+    ch = &cw->journal[--cw->nb_changes];
+    switch(ch->kind){
+    case CW_GRID :
+      cw->grid[ch->pos] = (char) ch->old;
+      break;
+    case CW_TGRID :
+      cw->tgrid[ch->pos] = (char) ch->old;
+      break;
+    case CW_LABELS :
+      cw->labels[ch->pos] = ch->old;
+      (*l)--;
+      break;
+    case CW_ROWS :
+      cw->rows[ch->pos] = (uint32_t) ch->old;
+      break;
+    case CW_COLS :
+      cw->cols[ch->pos] = (uint32_t) ch->old;
+      break;
+    case CW_HBLOCK :
+      cw->hblock[ch->pos] = (uint32_t) ch->old;
+      break;
+    case CW_VBLOCK :
+      cw->vblock[ch->pos] = (uint32_t) ch->old;
+      break;
+    case CW_OPEN_HEAD :
+      cw->open_head[ch->pos] = ch->old;
+      break;
+    case CW_OPEN_NEXT :
+      cw->open_next[ch->pos] = ch->old;
+      break;
+    case CW_USED :
+      cw->used[ch->pos] = (char) ch->old;
+      break;
+    case CW_NB_CROSS :
+      cw->nb_cross = ch->old;
+      break;
+    case CW_NB_CELLS :
+      cw->nb_cells = ch->old;
+      break;
+    case CW_XMIN :
+      cw->xmin = ch->old;
+      break;
+    case CW_YMIN :
+      cw->ymin = ch->old;
+      break;
+    case CW_XMAX :
+      cw->xmax = ch->old;
+      break;
+    case CW_YMAX :
+      cw->ymax = ch->old;
+      break;
+    default : // CW_NB_WORDS
+      cw->nb_words = ch->old;
+      break;
+    }
+  }
+}
+
 /*
  * Tells weather a word can be added at a specific position in the crossword.
  * cw : the crossword.
@@ -152,144 +388,215 @@ int cw_add_word(crossword cw, word_list wl,
  */
 int cw_ok_add_word_at_pos(crossword cw, word_list wl,
                           int i, int x, int y, int or){
-  int word_length = (int) strlen(wl->l[i].w);
-  int k;
-  int ok;
+  int word_length = wl->l[i].len;
+  uint32_t* line;        // Bitboards of the line of the word.
+  uint32_t block;        // Cells of the line covered by a parallel word.
+  uint32_t span, occ, side;
+  char* slot;            // The cells of the word, contiguous.
+  int b;
 
-  // Check if in min range.
+  // Check if in range.
   if((x < 0) || (y < 0)) return 0;
-
   if(or == HORIZONTAL){
-    // Check if in max range.
     if((y >= cw->height) || (x + word_length >= cw->width)) return 0;
+    line = &cw->rows[y + 1];
+    block = cw->hblock[y + 1];
+    b = x + 1;
+    slot = &CW_CELL(cw, x, y);
+  }else{
+    if((x >= cw->width) || (y + word_length >= cw->height)) return 0;
+    line = &cw->cols[x + 1];
+    block = cw->vblock[x + 1];
+    b = y + 1;
+    slot = &CW_TCELL(cw, x, y);
+  }
+  span = CW_BITS(word_length) << b;
 
-    // Check if we do not touch an other word at the extremities.
-    if(x > 0)
-      if(cw->grid[x - 1][y] != EMPTY_CHAR) return 0;
-    if(x + word_length < cw->width - 1)
-      if(cw->grid[x + word_length][y] != EMPTY_CHAR) return 0;
+  // Check if we do not touch an other word at the extremities.
+  if((line[0] >> (b - 1)) & 1) return 0;
+  if((line[0] >> (b + word_length)) & 1) return 0;
 
-    // Check that there is no overlap or that we don't touch on the sides.
-    for(k = x; k < (int) (x + strlen(wl->l[i].w)); k++){
-      ok = cw->grid[k][y] != EMPTY_CHAR;
-      if(y > 0) ok = ok || (cw->grid[k][y - 1] != EMPTY_CHAR);
-      if(y < cw->width - 1) ok = ok || (cw->grid[k][y + 1] != EMPTY_CHAR);
+  // Check that we do not overlap a parallel word, and that the cells that
+  // touch a word on the sides are crossings.
+  if(block & span) return 0;
+  occ = line[0] & span;
+  side = (line[-1] | line[1]) & span;
+  if(side & ~occ) return 0;
 
-      if(ok && (cw->grid[k][y] != wl->l[i].w[k - x])) return 0;
-    }
-  }else{
-    // Check if in max range.
-    if((x >= cw->width) || (y + word_length >= cw->height)) return 0;
+  // Check the letters of the crossings (the other cells are empty).
+  if(0 == occ) return 1;
+  return match_word(wl->l[i].w, slot, word_length);
+}
+ 
+/*
+ * Add a word to the crossword, crossing a word that is already placed. The
+ * cells that can be crossed are found through the open cells lists of the
+ * letters of the word, starting at a random letter.
+ * cw : the crossword.
+ * wl : the list of words.
+ * i  : the index of the word in wl.
+ * l  : label.
+ * rn : the random generator of the run.
+ * Return 1 if the word was added, 0 if it cannot be, -1 on error.
+ */
+int cw_add_crossing_word(crossword cw, word_list wl,
+                         int i, int* l, rng* rn){
+  int len = wl->l[i].len;
+  int start;
+  int j, k, c, prev;
+  int x, y, or, h, v;
 
-    // Check if we do not touch an other word at the extremities.
-    if(y > 0)
-      if(cw->grid[x][y - 1] != EMPTY_CHAR) return 0;
-    if(y + word_length < cw->height - 1)
-      if(cw->grid[x][y + word_length] != EMPTY_CHAR) return 0;
+  // No common letter with the open cells of the grid.
+  if(0 == (wl->l[i].letters & cw->open_letters)) return 0;
+
+  start = rng_int(rn, len);
+  for(k = 0; k < len; k++){
+    j = (start + k) % len;
+
+    prev = -1;
+    c = cw->open_head[(unsigned char) wl->l[i].w[j]];
+    while(-1 != c){
+      // The new word must be orthogonal to the one covering the cell.
+      x = c % cw->stride - 1;
+      y = c / cw->stride - 1;
+      h = (cw->hblock[y + 1] >> (x + 1)) & 1;
+      v = (cw->vblock[x + 1] >> (y + 1)) & 1;
+      if(v && !h){
+        or = HORIZONTAL;
+        x -= j;
+      }else if(h && !v){
+        or = VERTICAL;
+        y -= j;
+      }else{
+        // Already crossed, the cell is removed from the list.
+        c = cw->open_next[c];
+        if(-1 == prev){
+          cw_log(cw, CW_OPEN_HEAD, (unsigned char) wl->l[i].w[j],
+                 cw->open_head[(unsigned char) wl->l[i].w[j]]);
+          cw->open_head[(unsigned char) wl->l[i].w[j]] = c;
+        }else{
+          cw_log(cw, CW_OPEN_NEXT, prev, cw->open_next[prev]);
+          cw->open_next[prev] = c;
+        }
+        continue;
+      }
 
-    // Check that there is no overlap or that we don't touch on the sides.
-    for(k = y; k < (int) (y + strlen(wl->l[i].w)); k++){
-      ok = cw->grid[x][k] != EMPTY_CHAR;
-      if(x > 0) ok = ok || (cw->grid[x - 1][k] != EMPTY_CHAR);
-      if(x < cw->height - 1) ok = ok || (cw->grid[x + 1][k] != EMPTY_CHAR);
+      if(1 == cw_ok_add_word_at_pos(cw, wl, i, x, y, or)){
+        if(0 != cw_add_word(cw, wl, i, x, y, or, l)) return -1;
+        return 1;
+      }
 
-      if(ok  && (cw->grid[x][k] != wl->l[i].w[k - y])) return 0;
+      prev = c;
+      c = cw->open_next[c];
     }
   }
 
+  return 0;
+}
+
+/*
+ * Add a word at a random position of an empty crossword.
+ * cw : the crossword (empty).
+ * wl : the list of words.
+ * i  : the index of the word in wl.
+ * l  : label.
+ * rn : the random generator of the run.
+ * Return 1 if the word was added, 0 if it is too long, -1 on error.
+ */
+static int cw_place_first_word(crossword cw, word_list wl, int i, int* l,
+                               rng* rn){
+  int o, len;
+  int x, y;
+
+  o = rng_int(rn, 2);
+  len = wl->l[i].len;
+  if(len >= (o == VERTICAL ? cw->height : cw->width)) o = 1 - o;
+  if(len >= (o == VERTICAL ? cw->height : cw->width)) return 0; // Too long.
+  if(o == VERTICAL){
+    x = rng_int(rn, cw->width);
+    y = rng_int(rn, cw->height - len);
+  } else { // HORIZONTAL
+    x = rng_int(rn, cw->width - len);
+    y = rng_int(rn, cw->height);
+  }
+  if(0 != cw_add_word(cw, wl, i, x, y, o, l))
+    return -1;
   return 1;
 }
- 
+
+/*
+ * Add a word of the list, picked at random, at a random position of an
+ * empty crossword.
+ * cw : the crossword (empty).
+ * wl : the list of words (not empty).
+ * l  : label.
+ * rn : the random generator of the run.
+ * Return 1 if the word was added, 0 if it is too long, -1 on error.
+ */
+int cw_add_first_word(crossword cw, word_list wl, int* l, rng* rn){
+  return cw_place_first_word(cw, wl, rng_int(rn, wl->next_free), l, rn);
+}
+
 /*
  * Compute a crossword.
- * cw : the crossword. Must be initialized.
- * wl : the list of words.
+ * cw       : the crossword. Must be initialized and empty (see cw_reset).
+ * wl       : the list of words.
+ * rn       : the random generator of the run.
+ * deadline : deadline of the run, TIMER_NONE if none (see timer.h).
  * Returns 0 if all went well. -1 otherwise.
  */
-int cw_compute(crossword cw, word_list wl){
-  int o, len;
-  int i, j;
-  int nb_loop, nb_rand_ch;
+int cw_compute(crossword cw, word_list wl, rng* rn, long deadline){
+  return cw_compute_among(cw, wl, NULL, wl->next_free, rn, deadline);
+}
+
+/*
+ * Compute a crossword from some of the words of the list.
+ * cw       : the crossword. Must be initialized and empty (see cw_reset).
+ * wl       : the list of words.
+ * words    : the indices of the words in wl, NULL for all of them.
+ * nb       : the number of words.
+ * rn       : the random generator of the run.
+ * deadline : deadline of the run, TIMER_NONE if none (see timer.h).
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_compute_among(crossword cw, word_list wl, int* words, int nb,
+                     rng* rn, long deadline){
+  long nb_tried = 0;
+  int nb_fail = 0;
+  int i, res;
+  int nb_loop;
   int l = 1;
-  int r;
-  char ch;
-  int pos_word;
-  int x, y;
   int nb_pl;
 
   // No words to place.
-  if(0 == wl->next_free) return 0;
+  if(0 == nb) return 0;
 
   // Pick a word at random and place it at a random position.
-  i = rand() % wl->next_free;
-  o = rand() % 2;
-  len = strlen(wl->l[i].w);
-  wl->l[i].used = 1;
-  if(o == VERTICAL){
-    x = rand() % cw->width;
-    y = rand() % (cw->height - len);
-  } else { // HORIZONTAL
-    x = rand() % (cw->width - len);
-    y = rand() % cw->height;
-  }
-  if(0 != cw_add_word(cw, wl, i, x, y, o, &l))
-    return -1;
+  i = rng_int(rn, nb);
+  if(NULL != words) i = words[i];
+  if(1 != (res = cw_place_first_word(cw, wl, i, &l, rn)))
+    return res;
 
   // Place the other words.
   for(nb_loop = 0; nb_loop < NB_LOOP; nb_loop++)
-    for(nb_pl = 0; nb_pl < wl->next_free; nb_pl++){
+    for(nb_pl = 0; nb_pl < nb; nb_pl++){
       // We choose a word at random.
-      i = rand() % wl->next_free;
-
-      if(0 == wl->l[i].used){
-        for(nb_rand_ch = 0; nb_rand_ch < NB_RAND_CH; nb_rand_ch++){
-          // We try to insert the word using the word number r.
-          r = rand() % cw->nb_words;
-
-          for(pos_word = 0; pos_word < (int) strlen(cw->words[r].w.w); pos_word++){
-            ch = cw->words[r].w.w[pos_word];
-
-            // We look for a match.
-            for(j = 0; j < (int) strlen(wl->l[i].w); j++){
-              if(ch == wl->l[i].w[j]){
-                if(VERTICAL == cw->words[r].orient){
-                  // In this case, the new word will have to be horizontal.
-                  x = cw->words[r].posx - j;
-                  y = pos_word + cw->words[r].posy;
-
-                  if(1 == cw_ok_add_word_at_pos(cw, wl, i, x, y, HORIZONTAL)){
-                    // We place the word.
-                    if(0 != cw_add_word(cw, wl, i, x, y, HORIZONTAL, &l)){
-                      return -1;
-                    }
-                    /////// TODO improve...
-                    nb_rand_ch = NB_RAND_CH;
-                    pos_word = MAX_WORD_SIZE + 1;
-                    ///////
-                    break;
-                  }
-                }else{
-                  // In this case, the new word will have to be vertical.
-                  x = pos_word + cw->words[r].posx;
-                  y = cw->words[r].posy - j;
-
-                  if(1 == cw_ok_add_word_at_pos(cw, wl, i, x, y, VERTICAL)){
-                    // We place the word.
-                    if(0 != cw_add_word(cw, wl, i, x, y, VERTICAL, &l)){
-                      return -1;
-                    }
-                    /////// TODO improve...
-                    nb_rand_ch = NB_RAND_CH;
-                    pos_word = MAX_WORD_SIZE + 1;
-                    ///////
-                    break;
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
+      i = rng_int(rn, nb);
+      if(NULL != words) i = words[i];
+
+      res = 0;
+      if(0 == cw->used[i])
+        if(-1 == (res = cw_add_crossing_word(cw, wl, i, &l, rn)))
+          return -1;
+
+      // The grid is full when NB_FAIL words in a row cannot be added (so
+      // that the cost of a run grows with the grid, not with the list).
+      nb_fail = (1 == res) ? 0 : nb_fail + 1;
+      if(NB_FAIL == nb_fail) return 0;
+
+      // The grid is kept as it is when the time is over (the clock is only
+      // read every CW_CLOCK words).
+      if((0 == ++nb_tried % CW_CLOCK) && timer_expired(deadline)) return 0;
     }
   return 0;
 }
@@ -26,8 +26,11 @@
 #ifndef __CW_H__
 #define __CW_H__
 
+#include <stdint.h>
 #include "const.h"
 #include "word.h"
+#include "rng.h"
+#include "arena.h"
 
 /*
  * Constants for defining the orientation of a word in the grid.
@@ -39,23 +42,108 @@
  * Structure representing a word placed in the grid.
  */
 typedef struct __placed_word__{
-  word w;                // The word with its clue.
+  int w;                 // Index of the word (with its clue) in the list.
   int posx;              // X coordinate in the grid.
   int posy;              // Y coordinate in the grid.
   int orient;            // Orientation.
   int label;             // Label.
 }placed_word;
 
+/*
+ * Position of the cell (x,y) in the grid of a crossword. The grid has a
+ * border of empty cells, so that x can range from -1 to width and y from
+ * -1 to height.
+ */
+#define CW_POS(cw, x, y) (((y) + 1) * (cw)->stride + (x) + 1)
+
+/*
+ * The cell (x,y) of the grid of a crossword.
+ */
+#define CW_CELL(cw, x, y) ((cw)->grid[CW_POS(cw, x, y)])
+
+/*
+ * The label of the words starting at cell (x,y), -1 if none.
+ */
+#define CW_LABEL(cw, x, y) ((cw)->labels[CW_POS(cw, x, y)])
+
+/*
+ * Position of the cell (x,y) in the transposed grid of a crossword, and the
+ * cell itself. A vertical word is contiguous in the transposed grid.
+ */
+#define CW_TPOS(cw, x, y) (((x) + 1) * ((cw)->height + 2) + (y) + 1)
+#define CW_TCELL(cw, x, y) ((cw)->tgrid[CW_TPOS(cw, x, y)])
+
+/*
+ * Bits 0 to n - 1 of a bitboard.
+ */
+#define CW_BITS(n) ((((uint32_t) 1) << (n)) - 1)
+
+/*
+ * Arrays of a crossword whose changes are journaled.
+ */
+#define CW_GRID 0
+#define CW_TGRID 1
+#define CW_LABELS 2
+#define CW_ROWS 3
+#define CW_COLS 4
+#define CW_HBLOCK 5
+#define CW_VBLOCK 6
+#define CW_OPEN_HEAD 7
+#define CW_OPEN_NEXT 8
+#define CW_USED 9
+#define CW_NB_WORDS 10
+#define CW_NB_CROSS 11
+#define CW_NB_CELLS 12
+#define CW_XMIN 13
+#define CW_YMIN 14
+#define CW_XMAX 15
+#define CW_YMAX 16
+
+/*
+ * Structure representing a change of a crossword (see cw_journal_init).
+ */
+typedef struct __cw_change__{
+  int kind;              // The array changed (CW_GRID, ...).
+  int pos;               // Index of the change in the array.
+  int old;               // Value before the change.
+}cw_change;
+
 /*
  * Stucture representing a crossword.
  */
 typedef struct __crossword__{
   int width;             // Width of the grid.
   int height;            // Height of the grid.
-  char** grid;           // The grid.
+  int stride;            // Size of a row of the grid (width + 2).
+  char* grid;            // The grid, row by row, surrounded by empty cells
+                         // (see CW_CELL).
+  char* tgrid;           // The same grid, column by column (see CW_TCELL).
+  int* labels;           // Label of the words starting at each cell, -1 if
+                         // none, same layout as the grid (see CW_LABEL).
   placed_word* words;    // The words in the grid.
   int nb_words;          // Number of words in the grid.
+  int nb_cross;          // Number of crossings in the grid.
+  int nb_cells;          // Number of cells covered by a word.
+  int xmin, ymin;        // Bounding box of the words (xmin is width and
+  int xmax, ymax;        // xmax is -1 if the grid is empty, same for y).
   int size_wlist;        // Number of words that can be stored in the list.
+  char* used;            // Usage of the words of the list (1 if placed).
+  int nb_used;           // Size of the usage array (words in the list).
+  uint32_t rows[MAX_SIZE + 2];   // Occupied cells, by row: cell (x,y) is
+  uint32_t cols[MAX_SIZE + 2];   // bit x + 1 of rows[y + 1] and bit y + 1
+                                 // of cols[x + 1] (border included).
+  uint32_t hblock[MAX_SIZE + 2]; // Cells of horizontal words, by row.
+  uint32_t vblock[MAX_SIZE + 2]; // Cells of vertical words, by column.
+  int open_head[256];    // First open cell (crossed by only one word, so a
+                         // word can cross it) for each letter, -1 if none.
+  int* open_next;        // Next cell in the list of open cells, by cell.
+  uint32_t open_letters; // Letters that may have open cells (WORD_LETTER).
+  cw_change* journal;    // Changes of the crossword, NULL if the changes are
+                         // not journaled (see cw_journal_init).
+  int nb_changes;        // Number of changes in the journal.
+  int size_journal;      // Capacity of the journal.
+  int journal_error;     // Set to 1 if a change could not be journaled.
+  arena mem;             // Memory of the crossword (structure included).
 }*crossword;
 
 /*
@@ -63,9 +151,16 @@ typedef struct __crossword__{
  * cw : the crossword.
  * w  : the width of the crossword.
  * h  : the height of the crossword.
+ * nw : the number of words in the list the crossword is built from.
  * Returns 0 if all went well, -1 otherwise.
  */
-int cw_init(crossword* cw, int w, int h);
+int cw_init(crossword* cw, int w, int h, int nw);
+
+/*
+ * Empty a crossword, so that it can be computed again (no allocation).
+ * cw : the crossword.
+ */
+void cw_reset(crossword cw);
 
 /*
  * Free the memory allocated to a crossword.
@@ -74,11 +169,107 @@ int cw_init(crossword* cw, int w, int h);
 void cw_free(crossword cw);
 
 /*
- * Compute a crossword.
- * cw : the crossword. Must be initialized.
+ * Add a word to the crossword (its position must be valid).
+ * cw : the crossword.
  * wl : the list of words.
+ * i  : the index of the word in wl.
+ * x  : x coordinate where to insert.
+ * y  : y coordinate where to insert.
+ * or : orietation of the new word.
+ * l  : label.
+ * Return 0 if all went well. -1 otherwise.
+ */
+int cw_add_word(crossword cw, word_list wl,
+                int i, int x, int y, int or, int* l);
+
+/*
+ * Start journaling the changes of a crossword: every change done by
+ * cw_add_word (and cw_add_crossing_word) is then recorded, so that it can be
+ * undone (see cw_mark and cw_rollback). The journal is freed by cw_free, and
+ * emptied by cw_reset.
+ * cw : the crossword.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int cw_journal_init(crossword cw);
+
+/*
+ * Position in the journal of a crossword, to roll back to (see cw_rollback).
+ * cw : the crossword (journaled, see cw_journal_init).
+ * Returns the mark.
+ */
+int cw_mark(crossword cw);
+
+/*
+ * Undo the changes of a crossword done after a mark, in reverse order (the
+ * cost is proportional to the length of the words added since the mark).
+ * The open letters are not restored (it is only a filter).
+ * cw   : the crossword (journaled, see cw_journal_init).
+ * mark : the mark (see cw_mark).
+ * l    : label (the labels given since the mark are given back).
+ */
+void cw_rollback(crossword cw, int mark, int* l);
+
+/*
+ * Tells weather a word can be added at a specific position in the crossword.
+ * cw : the crossword.
+ * wl : the list of words.
+ * i  : the index of the word in wl.
+ * x  : x coordinate where we want to insert the word.
+ * y  : y coordinate where we want to insert the word.
+ * or : orietation of the word.
+ * Return 1 if it can be inserted, 0 otherwise.
+ */
+int cw_ok_add_word_at_pos(crossword cw, word_list wl,
+                          int i, int x, int y, int or);
+
+/*
+ * Add a word to the crossword, crossing a word that is already placed. The
+ * cells that can be crossed are found through the open cells lists of the
+ * letters of the word, starting at a random letter.
+ * cw : the crossword.
+ * wl : the list of words.
+ * i  : the index of the word in wl.
+ * l  : label.
+ * rn : the random generator of the run.
+ * Return 1 if the word was added, 0 if it cannot be, -1 on error.
+ */
+int cw_add_crossing_word(crossword cw, word_list wl,
+                         int i, int* l, rng* rn);
+
+/*
+ * Add a word of the list, picked at random, at a random position of an
+ * empty crossword.
+ * cw : the crossword (empty).
+ * wl : the list of words (not empty).
+ * l  : label.
+ * rn : the random generator of the run.
+ * Return 1 if the word was added, 0 if it is too long, -1 on error.
+ */
+int cw_add_first_word(crossword cw, word_list wl, int* l, rng* rn);
+
+/*
+ * Compute a crossword.
+ * cw       : the crossword. Must be initialized and empty (see cw_reset).
+ * wl       : the list of words.
+ * rn       : the random generator of the run.
+ * deadline : deadline of the run, TIMER_NONE if none (see timer.h). The
+ *            words placed when it passes are kept.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_compute(crossword cw, word_list wl, rng* rn, long deadline);
+
+/*
+ * Compute a crossword from some of the words of the list (see sample.h),
+ * as cw_compute does from all of them.
+ * cw       : the crossword. Must be initialized and empty (see cw_reset).
+ * wl       : the list of words.
+ * words    : the indices of the words in wl, NULL for all of them.
+ * nb       : the number of words.
+ * rn       : the random generator of the run.
+ * deadline : deadline of the run, TIMER_NONE if none (see timer.h).
  * Returns 0 if all went well. -1 otherwise.
  */
-int cw_compute(crossword cw, word_list wl);
+int cw_compute_among(crossword cw, word_list wl, int* words, int nb,
+                     rng* rn, long deadline);
 
 #endif
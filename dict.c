@@ -0,0 +1,221 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** dict.c ******************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "dict.h".                   *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "const.h"
+#include "word.h"
+#include "dict.h"
+
+/*
+ * Round an offset up to the alignment of the sections.
+ */
+#define DICT_ROUND(o) (((o) + DICT_ALIGN - 1) / DICT_ALIGN * DICT_ALIGN)
+
+/*
+ * Write padding up to an offset.
+ * out : the file.
+ * pos : the current offset (updated).
+ * off : the offset to reach.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+static int dict_pad(FILE* out, uint64_t* pos, uint64_t off){
+  for( ; *pos < off; (*pos)++)
+    if(EOF == putc('\0', out)) return -1;
+  return 0;
+}
+
+/*
+ * Report a write error.
+ * Returns -1.
+ */
+static int dict_write_error(void){
+  fprintf(stderr, "Write error in dict_write !\n");
+  return -1;
+}
+
+/*
+ * Write a compiled list.
+ * out : the file where to write.
+ * wl  : the list of words (read from a text file, so checked).
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int dict_write(FILE* out, word_list wl){
+  dict_header h;
+  word rec;
+  uint64_t pos;
+  uint32_t d = 0;
+  int i;
+
+  // Header.
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, DICT_MAGIC, sizeof(h.magic));
+  h.version = DICT_VERSION;
+  h.endian = DICT_ENDIAN;
+  h.word_size = sizeof(word);
+  h.nb_words = wl->next_free;
+  h.words_off = DICT_ROUND(sizeof(dict_header));
+  h.index_off = DICT_ROUND(h.words_off + h.nb_words * sizeof(word));
+  h.nb_index = wl->index_start[256];
+  h.text_off = DICT_ROUND(h.index_off + h.nb_index * sizeof(word_pos));
+  for(i = 0; i < wl->next_free; i++) h.text_size += wl->l[i].dlen + 1;
+  for(i = 0; i < 257; i++) h.index_start[i] = wl->index_start[i];
+  if(1 != fwrite(&h, sizeof(h), 1, out)) return dict_write_error();
+  pos = sizeof(h);
+
+  // Words records, the clues are packed in the order of the words.
+  if(0 != dict_pad(out, &pos, h.words_off)) return dict_write_error();
+  for(i = 0; i < wl->next_free; i++){
+    rec = wl->l[i];
+    rec.d = d;
+    d += rec.dlen + 1;
+    if(1 != fwrite(&rec, sizeof(word), 1, out)) return dict_write_error();
+  }
+  pos += h.nb_words * sizeof(word);
+
+  // Letter index.
+  if(0 != dict_pad(out, &pos, h.index_off)) return dict_write_error();
+  if(h.nb_index != fwrite(wl->index, sizeof(word_pos), h.nb_index, out))
+    return dict_write_error();
+  pos += h.nb_index * sizeof(word_pos);
+
+  // Clues ('\0' terminated, for convenience).
+  if(0 != dict_pad(out, &pos, h.text_off)) return dict_write_error();
+  for(i = 0; i < wl->next_free; i++){
+    if((size_t) wl->l[i].dlen !=
+       fwrite(WORD_CLUE(wl, i), 1, wl->l[i].dlen, out))
+      return dict_write_error();
+    if(EOF == putc('\0', out)) return dict_write_error();
+  }
+
+  return 0;
+}
+
+/*
+ * Tells whether the content of a file is a compiled list.
+ * data : the content.
+ * size : the size of the content.
+ * Returns 1 if it starts like a compiled list, 0 otherwise.
+ */
+int dict_is_compiled(const char* data, size_t size){
+  return (size >= sizeof(DICT_MAGIC)) &&
+         (0 == memcmp(data, DICT_MAGIC, sizeof(DICT_MAGIC)));
+}
+
+/*
+ * Tells whether a section of a compiled list is inside the file (with no
+ * overflow).
+ * off  : the offset of the section.
+ * nb   : the number of elements of the section.
+ * size : the size of an element.
+ * max  : the size of the file.
+ * Returns 1 if the section is inside the file, 0 otherwise.
+ */
+static int dict_section_ok(uint64_t off, uint64_t nb, uint64_t size,
+                           uint64_t max){
+  return (off <= max) && (nb <= (max - off) / size);
+}
+
+/*
+ * Check the records and the letter index of a compiled list, so that a
+ * corrupted file cannot make the program read outside of it.
+ * h    : the header.
+ * l    : the words records.
+ * ind  : the letter index.
+ * text : the clues.
+ * Returns 0 if all went well, -1 if the content is not valid.
+ */
+static int dict_check(const dict_header* h, const word* l,
+                      const word_pos* ind, const char* text){
+  uint64_t i;
+  int c;
+
+  // Words, and their clues ('\0' terminated) inside the text.
+  for(i = 0; i < h->nb_words; i++){
+    if((l[i].len < 1) || (l[i].len > MAX_WORD_SIZE) ||
+       ((int) strnlen(l[i].w, WORD_STORAGE) != l[i].len) ||
+       (l[i].d < 0) || (l[i].dlen < 0) ||
+       ((uint64_t) l[i].d + l[i].dlen >= h->text_size) ||
+       ('\0' != text[l[i].d + l[i].dlen]))
+      return -1;
+  }
+
+  // Letter index: sorted by letter, each entry on its letter.
+  if(0 != h->index_start[0]) return -1;
+  for(c = 0; c < 256; c++)
+    if(h->index_start[c] > h->index_start[c + 1]) return -1;
+  for(c = 0; c < 256; c++)
+    for(i = h->index_start[c]; i < (uint64_t) h->index_start[c + 1]; i++){
+      if((ind[i].w < 0) || ((uint64_t) ind[i].w >= h->nb_words) ||
+         (ind[i].pos < 0) || (ind[i].pos >= l[ind[i].w].len) ||
+         ((unsigned char) l[ind[i].w].w[ind[i].pos] != c))
+        return -1;
+    }
+  return 0;
+}
+
+/*
+ * Use the content of a list of words (wl->data) as a compiled list.
+ * wl : the list of words.
+ * Returns 0 if all went well, -1 if the content is not valid.
+ */
+int dict_open(word_list wl){
+  const dict_header* h = (const dict_header*) wl->data;
+  int i;
+
+  // Check that the file was written by this kind of machine, and that the
+  // sections are inside the file.
+  if(wl->data_size < sizeof(dict_header)){
+    fprintf(stderr, "Invalid compiled list (truncated)...\n");
+    return -1;
+  }
+  if((DICT_VERSION != h->version) || (DICT_ENDIAN != h->endian) ||
+     (sizeof(word) != h->word_size)){
+    fprintf(stderr, "Invalid compiled list (version %u), recompile it...\n",
+            h->version);
+    return -1;
+  }
+  if(!dict_section_ok(h->words_off, h->nb_words, sizeof(word),
+                      wl->data_size) ||
+     !dict_section_ok(h->index_off, h->nb_index, sizeof(word_pos),
+                      wl->data_size) ||
+     !dict_section_ok(h->text_off, h->text_size, 1, wl->data_size) ||
+     (h->nb_words > INT_MAX) ||
+     (h->nb_index != (uint64_t) h->index_start[256]) ||
+     (0 != h->words_off % DICT_ALIGN) || (0 != h->index_off % DICT_ALIGN) ||
+     (0 != dict_check(h, (const word*) (wl->data + h->words_off),
+                      (const word_pos*) (wl->data + h->index_off),
+                      wl->data + h->text_off))){
+    fprintf(stderr, "Invalid compiled list (corrupted)...\n");
+    return -1;
+  }
+
+  wl->compiled = 1;
+  wl->l = (word*) (wl->data + h->words_off);
+  wl->next_free = h->nb_words;
+  wl->size = h->nb_words;
+  wl->index = (word_pos*) (wl->data + h->index_off);
+  for(i = 0; i < 257; i++) wl->index_start[i] = h->index_start[i];
+  wl->text = wl->data + h->text_off;
+  wl->text_size = h->text_size;
+  return 0;
+}
@@ -0,0 +1,83 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** dict.h ******************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the compiled lists of words: a binary file holding the   *
+ *   words records, the letter index and the clues, that can be mapped in   *
+ *   memory and used without any parsing. The file is only valid on the     *
+ *   kind of machine that wrote it (endianness, layout of the records).     *
+ * Format of a compiled list:                                               *
+ *   header | words records | letter index | clues                          *
+ ****************************************************************************/
+#ifndef __DICT_H__
+#define __DICT_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "word.h"
+
+/*
+ * Identification of a compiled list.
+ */
+#define DICT_MAGIC "CWGDICT"   // Magic string (8 bytes with the '\0').
+#define DICT_VERSION 2         // Version of the format.
+#define DICT_ENDIAN 0x01020304 // Written as a native integer.
+#define DICT_ALIGN 64          // Alignment of the sections in the file.
+
+/*
+ * Header of a compiled list.
+ */
+typedef struct __dict_header__{
+  char magic[8];             // DICT_MAGIC.
+  uint32_t version;          // DICT_VERSION.
+  uint32_t endian;           // DICT_ENDIAN.
+  uint32_t word_size;        // Size of a word record.
+  uint32_t nb_words;         // Number of words.
+  uint64_t words_off;        // Offset of the words records.
+  uint64_t index_off;        // Offset of the letter index.
+  uint64_t nb_index;         // Number of entries of the letter index.
+  uint64_t text_off;         // Offset of the clues.
+  uint64_t text_size;        // Size of the clues.
+  int32_t index_start[257];  // Starts of the letters in the index.
+}dict_header;
+
+/*
+ * Write a compiled list.
+ * out : the file where to write.
+ * wl  : the list of words (read from a text file, so checked).
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int dict_write(FILE* out, word_list wl);
+
+/*
+ * Tells whether the content of a file is a compiled list.
+ * data : the content.
+ * size : the size of the content.
+ * Returns 1 if it starts like a compiled list, 0 otherwise.
+ */
+int dict_is_compiled(const char* data, size_t size);
+
+/*
+ * Use the content of a list of words (wl->data) as a compiled list: the
+ * records, the index and the clues point into the content. Every record and
+ * index entry is checked once, so that a corrupted file is refused.
+ * wl : the list of words.
+ * Returns 0 if all went well, -1 if the content is not valid.
+ */
+int dict_open(word_list wl);
+
+#endif
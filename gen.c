@@ -0,0 +1,273 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** gen.c *******************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "gen.h".                    *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "arena.h"
+#include "timer.h"
+#include "score.h"
+#include "sample.h"
+#include "search.h"
+#include "anneal.h"
+#include "gen.h"
+
+/*
+ * State shared by the workers of a generation.
+ */
+typedef struct __gen_shared__{
+  pthread_mutex_t lock;  // Protects all the fields below.
+  word_list wl;          // The list of words.
+  gen_params* p;         // The parameters.
+  int next_try;          // Next run to be started.
+  int stop_try;          // No run with this index or more is started.
+  long deadline;         // No run is started after it (see timer.h).
+  word_sampler sampler;  // Subsets of the list for the random runs.
+  int sampling;          // 1 if the random runs use a subset of the list.
+  crossword best;        // Best crossword so far.
+  long best_score;       // Score of the best crossword.
+  long bound;            // Upper bound of the score (see score_bound).
+  int best_try;          // Run that produced the best crossword.
+  int error;             // Set to 1 if a worker failed.
+}gen_shared;
+
+/*
+ * Worker: runs the algorithm until there is no run left. Each worker owns
+ * two crosswords (current and spare) allocated once: a better crossword is
+ * swapped with the shared best one, so that no allocation is done between
+ * two runs. The state of a search is allocated in a scratch arena, reset
+ * before each run.
+ * arg : the shared state (gen_shared*).
+ * Returns NULL.
+ */
+static void* gen_worker(void* arg){
+  gen_shared* s = (gen_shared*) arg;
+  crossword cw = NULL;
+  crossword spare = NULL;
+  crossword tmp;
+  arena scratch;
+  char* marks = NULL;
+  int* subset = NULL;
+  rng rn;
+  long score;
+  int t, res, nb;
+
+  // Allocation of the crosswords.
+  if((0 != cw_init(&cw, s->p->width, s->p->height, s->wl->next_free)) ||
+     (0 != cw_init(&spare, s->p->width, s->p->height, s->wl->next_free))){
+    fprintf(stderr, "Error while initializing the crossword !\n");
+    pthread_mutex_lock(&s->lock);
+    s->error = 1;
+    pthread_mutex_unlock(&s->lock);
+    return NULL; // Process about to fail, memory not freed.
+  }
+  arena_init(&scratch, 0);
+  if(s->sampling &&
+     ((NULL == (marks = calloc(s->wl->next_free, sizeof(char)))) ||
+      (NULL == (subset = malloc(s->sampler.size * sizeof(int)))))){
+    fprintf(stderr, "Malloc error in gen_worker !\n");
+    pthread_mutex_lock(&s->lock);
+    s->error = 1;
+    pthread_mutex_unlock(&s->lock);
+    return NULL; // Process about to fail, memory not freed.
+  }
+
+  while(1){
+    // Take the next run.
+    pthread_mutex_lock(&s->lock);
+    t = s->next_try;
+    if((t > 0) && (t < s->stop_try) && timer_expired(s->deadline)){
+      s->stop_try = t;
+      if(s->p->verbose) fprintf(stderr, "Time limit reached.\n");
+    }
+    if(s->error || t >= s->stop_try){
+      pthread_mutex_unlock(&s->lock);
+      break;
+    }
+    s->next_try++;
+    pthread_mutex_unlock(&s->lock);
+
+    // Computing the crossword, with its own random stream.
+    cw_reset(cw);
+    rng_seed(&rn, rng_derive(s->p->seed, t));
+    if(ALGO_SEARCH == s->p->algo){
+      arena_reset(&scratch);
+      res = cw_search(cw, s->wl, &rn, &scratch, s->p->nodes,
+                      s->deadline);
+    }else if(s->sampling){
+      nb = sampler_draw(&s->sampler, &rn, marks, subset);
+      res = cw_compute_among(cw, s->wl, subset, nb, &rn, s->deadline);
+    }else{
+      res = cw_compute(cw, s->wl, &rn, s->deadline);
+    }
+    if(0 != res){
+      fprintf(stderr, "Error while computing the crossword !\n");
+      pthread_mutex_lock(&s->lock);
+      s->error = 1;
+      pthread_mutex_unlock(&s->lock);
+      break;
+    }
+
+    // Keep the best (highest score, then first run).
+    score = cw_score(cw, &s->p->weights);
+    pthread_mutex_lock(&s->lock);
+    if(NULL == s->best){
+      s->best = cw;
+      s->best_score = score;
+      s->best_try = t;
+      cw = spare;
+      spare = NULL;
+
+      if(s->p->verbose)
+        fprintf(stderr, "First try, %d/%d words placed.\n",
+                        s->best->nb_words, s->wl->next_free);
+    } else if((score > s->best_score) ||
+              ((score == s->best_score) && (t < s->best_try))){
+      tmp = s->best;
+      s->best = cw;
+      s->best_score = score;
+      s->best_try = t;
+      cw = tmp;
+
+      if(s->p->verbose)
+        fprintf(stderr, "Did better: %d/%d words placed.\n",
+                        s->best->nb_words, s->wl->next_free);
+    }
+
+    // Optimization: the runs after an optimal one are useless.
+    if((s->best->nb_words == s->wl->next_free) &&
+       (s->best_score >= s->bound) && (s->best_try + 1 < s->stop_try)){
+      s->stop_try = s->best_try + 1;
+      if(s->p->verbose) fprintf(stderr, "Optimal reached.\n");
+    }
+    pthread_mutex_unlock(&s->lock);
+  }
+
+  arena_free(&scratch);
+  free(marks);
+  free(subset);
+  cw_free(cw);
+  if(NULL != spare) cw_free(spare);
+  return NULL;
+}
+
+/*
+ * Run the algorithm several times and keep the best crossword.
+ * best : the best crossword (result).
+ * wl   : the list of words.
+ * p    : the parameters of the generation.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int cw_generate(crossword* best, word_list wl, gen_params* p){
+  gen_shared s;
+  pthread_t* th = NULL;
+  int nb_th = p->nb_threads;
+  long deadline = timer_deadline(p->time_ms);
+  long ms = (ALGO_ANNEAL == p->algo) ? p->anneal_ms : 0;
+  long end;
+  rng rn;
+  int i;
+
+  // With a time limit, the local search gets at most half of it.
+  if((TIMER_NONE != deadline) && (ms > p->time_ms / 2)) ms = p->time_ms / 2;
+
+  s.wl = wl;
+  s.p = p;
+  s.next_try = 0;
+  s.stop_try = p->tries;
+  s.deadline = (TIMER_NONE == deadline) ? TIMER_NONE : deadline - ms;
+  s.best = NULL;
+  s.best_score = 0;
+  s.bound = score_bound(wl, p->width, p->height, &p->weights);
+  s.best_try = -1;
+  s.error = 0;
+  // Large lists are sampled by the random runs.
+  s.sampling = 0;
+  if(ALGO_SEARCH != p->algo){
+    s.sampling = sampler_init(&s.sampler, wl, p->width, p->height);
+    if(-1 == s.sampling) return -1;
+    if(s.sampling && p->verbose)
+      fprintf(stderr, "Runs on %d words drawn from %d.\n", s.sampler.size,
+                      wl->next_free);
+  }
+  if(0 != pthread_mutex_init(&s.lock, NULL)){
+    fprintf(stderr, "Mutex initialization error in cw_generate !\n");
+    if(s.sampling) sampler_free(&s.sampler);
+    return -1;
+  }
+
+  if(nb_th > p->tries) nb_th = p->tries;
+  if(nb_th < 1) nb_th = 1;
+
+  // The calling thread is the first worker.
+  if(nb_th > 1){
+    if(NULL == (th = malloc((nb_th - 1) * sizeof(pthread_t)))){
+      fprintf(stderr, "Malloc error in cw_generate !\n");
+      pthread_mutex_destroy(&s.lock);
+      if(s.sampling) sampler_free(&s.sampler);
+      return -1;
+    }
+    for(i = 0; i < nb_th - 1; i++){
+      if(0 != pthread_create(&th[i], NULL, gen_worker, &s)){
+        fprintf(stderr, "Thread creation error in cw_generate !\n");
+        nb_th = i + 1;
+        break;
+      }
+    }
+  }
+  gen_worker(&s);
+  for(i = 0; i < nb_th - 1; i++) pthread_join(th[i], NULL);
+  free(th);
+  pthread_mutex_destroy(&s.lock);
+
+  if(s.error){
+    if(s.sampling) sampler_free(&s.sampler);
+    if(NULL != s.best) cw_free(s.best);
+    return -1;
+  }
+
+  if(p->verbose)
+    fprintf(stderr, "Best crossword found by run %d (seed %llu).\n",
+                    s.best_try,
+                    (unsigned long long) rng_derive(p->seed, s.best_try));
+
+  // Improvement of the best crossword (its own random stream).
+  if(ALGO_ANNEAL == p->algo){
+    // It ends after its own budget, and no later than the time limit.
+    end = timer_deadline(ms);
+    if((TIMER_NONE != deadline) && (TIMER_NONE != end) && (end > deadline))
+      end = deadline;
+    rng_seed(&rn, rng_derive(p->seed, p->tries));
+    if(0 != cw_anneal(s.best, wl, &rn, end, &p->weights,
+                      s.sampling ? &s.sampler : NULL, p->verbose)){
+      if(s.sampling) sampler_free(&s.sampler);
+      cw_free(s.best);
+      return -1;
+    }
+  }
+  if(s.sampling) sampler_free(&s.sampler);
+
+  *best = s.best;
+  return 0;
+}
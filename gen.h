@@ -0,0 +1,74 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** gen.h *******************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the generation engine. The algorithm of "cw.h" is run    *
+ *   several times (possibly on several threads) and the best crossword is  *
+ *   kept.                                                                  *
+ ****************************************************************************/
+#ifndef __GEN_H__
+#define __GEN_H__
+
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "score.h"
+
+/*
+ * Algorithms used for the runs.
+ */
+#define ALGO_RANDOM 0      // Random placement (see cw_compute).
+#define ALGO_SEARCH 1      // Depth first search (see cw_search).
+#define ALGO_ANNEAL 2      // Random placement, then the best crossword is
+                           // improved by local search (see cw_anneal).
+
+/*
+ * Parameters of a generation.
+ */
+typedef struct __gen_params__{
+  int width;             // Width of the crosswords.
+  int height;            // Height of the crosswords.
+  int tries;             // Number of runs of the algorithm.
+  int nb_threads;        // Number of worker threads.
+  int algo;              // Algorithm of the runs (ALGO_RANDOM, ALGO_SEARCH).
+  long nodes;            // Maximal number of nodes of a search.
+  long anneal_ms;        // Time of the local search, in milliseconds.
+  long time_ms;          // Time limit of the generation, 0 if none.
+  score_weights weights; // Score of the crosswords (see score.h).
+  uint64_t seed;         // Seed of the generation (see rng_derive).
+  int verbose;           // If set to 1 verbose mode. 0 otherwise.
+}gen_params;
+
+/*
+ * Run the algorithm several times and keep the best crossword. The runs are
+ * spread over p->nb_threads threads, and all of them stop as soon as the
+ * best possible score is reached. The result does not depend on the number
+ * of threads: the best crossword is the one with the highest score (see
+ * score.h), the first run wins in case of a tie.
+ * With a time limit, no run is started after the deadline (but the first
+ * one), searches stop at the deadline and the local search is shortened so
+ * that the generation ends in time. The result then depends on the speed of
+ * the machine.
+ * best : the best crossword (result).
+ * wl   : the list of words.
+ * p    : the parameters of the generation.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+int cw_generate(crossword* best, word_list wl, gen_params* p);
+
+#endif
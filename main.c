@@ -23,21 +23,21 @@
  ****************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <unistd.h>
 #include <getopt.h>
 #include <time.h>
 #include "const.h"
 #include "word.h"
 #include "cw.h"
+#include "gen.h"
+#include "score.h"
+#include "batch.h"
+#include "serve.h"
+#include "dict.h"
 #include "output.h"
 
-/*
- * Output formats
- */
-#define TEXT_FORMAT 0
-#define LATEX_FORMAT 1
-#define HTML_FORMAT 2
-
 /*
  * Verbose mode.
  */
@@ -63,9 +63,50 @@ void display_help(char* pname);
  *        0 default
  *        1 latex
  * nr   : number of runs for the program.
+ * nt   : number of threads.
+ * s    : seed of the random generator (result).
+ * k    : if set to 1 malformed lines of the input are skipped.
+ * a    : algorithm of the runs (see gen.h).
+ * t    : time limit in milliseconds, 0 if none.
+ * o    : weights of the score of the crosswords (see score.h).
+ * nb   : number of crosswords of a batch, 0 if not in batch mode.
+ * m    : manifest of a batch (result), NULL if none.
+ * p    : prefix of the output files of a batch (result), NULL if none.
+ * Returns 1 if a seed was given. 0 otherwise.
+ */
+int get_args(int argc, char** argv, FILE** i, int* w, int* h, int* v, int* f,
+             int* nr, int* nt, unsigned long long* s, int* k, int* a,
+             long* t, score_weights* o, int* nb, FILE** m, char** p);
+
+/*
+ * Compile a list of words (see dict.h).
+ * argc : argc, starting at the "compile" command.
+ * argv : argv, starting at the "compile" command.
+ * Returns the exit status of the program.
+ */
+int compile_main(int argc, char** argv);
+
+/*
+ * Serve crosswords (see serve.h).
+ * argc : argc, starting at the "serve" command.
+ * argv : argv, starting at the "serve" command.
+ * Returns the exit status of the program.
  */
-void get_args(int argc, char** argv,
-              FILE** i, int* w, int* h, int* v, int* f, int* nr);
+int serve_main(int argc, char** argv);
+
+/*
+ * Generate a batch of crosswords (see batch.h).
+ * words    : the list of words.
+ * params   : the parameters of the generations.
+ * manifest : the manifest of the batch, NULL if none.
+ * count    : the number of crosswords (if there is no manifest).
+ * prefix   : the prefix of the output files, NULL for the standard output.
+ * format   : the output format.
+ * verbose  : if set to 1 verbose mode. 0 otherwise.
+ * Returns the exit status of the program.
+ */
+int batch_main(word_list words, gen_params* params, FILE* manifest,
+               int count, char* prefix, int format, int verbose);
 
 /*
  * Main program.
@@ -77,111 +118,102 @@ int main(int argc, char** argv){
   int verbose = VERBOSE_OFF;
   int format = TEXT_FORMAT;
   FILE* input = NULL;
-  int tries = NB_RUN; // TODO add in getargs
+  int tries = 0;
+  int threads = 1;
+  unsigned long long seed = 0;
+  int lenient = 0;
+  int algo = ALGO_RANDOM;
+  long time_ms = 0;
+  score_weights weights;
+  int count = 0;
+  FILE* manifest = NULL;
+  char* prefix = NULL;
 
   // Variables for the program.
   word_list words = NULL;
-  crossword cw = NULL;
   int best_nr = -1;
   crossword best_cw = NULL;
-  int i;
+  gen_params params;
+  int status;
 
-  // Random initialization
-  srand(time(NULL));
+  // Compilation of a list of words.
+  if((argc > 1) && (0 == strcmp(argv[1], "compile")))
+    return compile_main(argc - 1, argv + 1);
+
+  // Server mode.
+  if((argc > 1) && (0 == strcmp(argv[1], "serve")))
+    return serve_main(argc - 1, argv + 1);
 
   // Parse arguments.
-  get_args(argc, argv, &input, &width, &height, &verbose, &format, &tries);
+  if(0 == get_args(argc, argv, &input, &width, &height, &verbose, &format,
+                   &tries, &threads, &seed, &lenient, &algo, &time_ms,
+                   &weights, &count, &manifest, &prefix))
+    seed = (unsigned long long) time(NULL);
+  // With a time limit, the number of runs is not bounded by default.
+  if(0 == tries) tries = (time_ms > 0) ? INT_MAX : NB_RUN;
   if(verbose) fprintf(stderr, "Parsing command line done.\n\n");
 
   // Reading input file.
   if(verbose) fprintf(stderr, "Reading words from the words file...\n");
-  fscan_words(input, &words, verbose);
+  fscan_words(input, &words, threads, lenient, verbose);
+  fprint_diags(stderr, words);
   if(0 != fclose(input)){
     fprintf(stderr, "Error while closing the input file !\n");
     free_words(words);
     exit(EXIT_FAILURE);
   }
+  if(verbose) arena_print_stats(stderr, "word list", &words->mem);
   if(verbose) fprintf(stderr, "Done.\n\n");
 
-  for(i = 0; i < tries; i++){
-    // Initialisation of the crossword.
-    if(0 != cw_init(&cw, width, height)){
-      fprintf(stderr, "Error while initializing the crossword !\n");
-      free_words(words);
-      exit(EXIT_FAILURE);
-    }
-
-    // Computing the crosword.
-    if(0 != cw_compute(cw, words)){
-      fprintf(stderr, "Error while computing the crossword !\n");
-      free_words(words);
-      cw_free(cw);
-      if(NULL != best_cw) cw_free(best_cw);
-      exit(-1);
-    }
+  // Parameters of the generation.
+  params.width = width;
+  params.height = height;
+  params.tries = tries;
+  params.nb_threads = threads;
+  params.algo = algo;
+  params.nodes = SEARCH_NODES;
+  params.anneal_ms = ANNEAL_MS;
+  params.time_ms = time_ms;
+  params.weights = weights;
+  params.seed = (uint64_t) seed;
+  params.verbose = verbose;
 
-    // Check if first try.
-    if(NULL == best_cw){
-      best_cw = cw;
-      best_nr = best_cw->nb_words;
-
-      if(verbose)
-        fprintf(stderr, "First try, %d/%d words placed.\n",
-                        cw->nb_words, words->next_free);
-    } else if(cw->nb_words > best_nr){ // Check if better
-      cw_free(best_cw);
-      best_cw = cw;
-      best_nr = best_cw->nb_words;
-
-      if(verbose)
-        fprintf(stderr, "Did better: %d/%d words placed.\n",
-                        cw->nb_words, words->next_free);
-    } else { // Not better...
-      cw_free(cw);
-      all_words_unused(words);
-    }
+  // Batch mode: many crosswords from the same list.
+  if((count > 0) || (NULL != manifest)){
+    status = batch_main(words, &params, manifest, count, prefix, format,
+                        verbose);
+    free_words(words);
+    return status;
+  }
 
-    // Optimization
-    if(best_nr == words->next_free){
-      if(verbose) fprintf(stderr, "Optimal reached.\n");
-      break;
-    }
+  // Computing the crossword (best of several runs).
+  if(0 != cw_generate(&best_cw, words, &params)){
+    fprintf(stderr, "Error while computing the crossword !\n");
+    free_words(words);
+    exit(-1);
   }
+  best_nr = best_cw->nb_words;
 
-  if(verbose) fprintf(stderr, "\nNumber of word placed: %d/%d\n\n",
+  if(verbose) fprintf(stderr, "\nNumber of word placed: %d/%d\n",
                               best_nr, words->next_free);
-
-  // Can now free the word list.
-  if(verbose) fprintf(stderr, "Liberating words memory...\n");
-  free_words(words);
-  if(verbose) fprintf(stderr, "Done.\n\n");
+  if(verbose) fprintf(stderr, "Score: %ld (%d crossings, %d cells, %dx%d).\n",
+                              cw_score(best_cw, &weights), best_cw->nb_cross,
+                              best_cw->nb_cells,
+                              best_cw->xmax - best_cw->xmin + 1,
+                              best_cw->ymax - best_cw->ymin + 1);
+  if(verbose) arena_print_stats(stderr, "crossword", &best_cw->mem);
+  if(verbose) fprintf(stderr, "\n");
 
   // Printing the crossword.
-  switch(format){
-  case TEXT_FORMAT :
-    if(verbose) fprintf(stderr, "Printing crossword in text mode...\n");
-    cw_print(stdout, best_cw);
-    break;
-  case LATEX_FORMAT :
-    if(verbose) fprintf(stderr, "Printing crossword in LaTeX mode...\n");
-    if(verbose) cw_print(stderr, best_cw);
-    if(0 != cw_print_latex(best_cw)){
-      fprintf(stderr, "Error while printing the crossword... (LaTeX mode)\n");
-      cw_free(best_cw);
-      exit(-1);
-    }
-    break;
-  case HTML_FORMAT :
-    if(verbose) fprintf(stderr, "Printing crossword in HTML mode...\n");
-    if(verbose) cw_print(stderr, best_cw);
-    if(0 != cw_print_html(best_cw)){
-      fprintf(stderr, "Error while printing the crossword... (HTML mode)\n");
-      cw_free(best_cw);
-      exit(-1);
-    }
-    break;
-  default :
-    break;
+  if(verbose) fprintf(stderr, "Printing crossword in %s mode...\n",
+                              output_backends[format].title);
+  if(verbose && (TEXT_FORMAT != format)) cw_print(stderr, best_cw, words);
+  if(0 != cw_print_format(stdout, best_cw, words, format)){
+    fprintf(stderr, "Error while printing the crossword... (%s mode)\n",
+            output_backends[format].title);
+    cw_free(best_cw);
+    free_words(words);
+    exit(-1);
   }
   if(verbose) fprintf(stderr, "Done.\n\n");
 
@@ -189,6 +221,9 @@ int main(int argc, char** argv){
   if(verbose) fprintf(stderr, "Liberating crossword memory...\n");
   cw_free(best_cw);
   if(verbose) fprintf(stderr, "Done.\n\n");
+  if(verbose) fprintf(stderr, "Liberating words memory...\n");
+  free_words(words);
+  if(verbose) fprintf(stderr, "Done.\n\n");
 
   if(verbose) fprintf(stderr, "End of the program.\n");
   return 0;
@@ -205,18 +240,254 @@ void display_help(char* pname){
   printf("  -W int    : set the width of the crosswords.\n");
   printf("  -H int    : set the height of the crosswords.\n");
   printf("  -n int    : number of runs, best crossword kept.\n");
+  printf("  -j int    : number of threads (parsing and runs).\n");
+  printf("  -s int    : seed of the random generator.\n");
+  printf("  -k        : skip the malformed lines of the input file.\n");
+  printf("  -a algo   : algorithm, random (default), search or anneal\n");
+  printf("              (random runs, then %d ms of local search).\n",
+         ANNEAL_MS);
+  printf("  -t int    : time limit in milliseconds (the number of runs is\n");
+  printf("              not bounded if -n is not given).\n");
+  printf("  --objective weights : score of the best crossword, the default\n");
+  printf("              is words=4096,crossings=64,density=0,area=-1.\n");
+  printf("  -N int    : batch of crosswords (seeds s, s + 1...).\n");
+  printf("  -m file   : batch given by a file, one crossword per line\n");
+  printf("              (width height [seed]).\n");
+  printf("  -o prefix : batch printed in files (prefix0001.txt...).\n");
   printf("  -v        : verbose mode.\n");
   printf("  -l        : latex format.\n");
   printf("  -w        : web format.\n");
+  printf("  -f format : text (default), latex, html or json.\n");
   printf("  -h        : display this help message.");
   printf("\n");
+  printf("Usage: %s compile file -o output [-j int] [-k] [-v]\n", pname);
+  printf("  Compile a list of words, the output can be given to -i.\n");
+  printf("Usage: %s serve -i file [-i file...] [-u socket] [-j int]\n",
+         pname);
+  printf("              [-q int] [-k] [-v]\n");
+  printf("  Load lists of words once and serve crosswords on a Unix domain\n");
+  printf("  socket (or on the standard input), with -j workers and a queue\n");
+  printf("  of -q connections (see serve.h for the protocol).\n");
+  printf("\n");
   printf("Examples:\n");
   printf("  %s -i words.txt > crossword.txt\n", pname);
   printf("  %s -li words.txt | rubber-pipe --pdf > crossword.pdf\n", pname);
   printf("  %s -wi words.txt > crossword.html\n", pname);
+  printf("  %s -f json -i words.txt > crossword.json\n", pname);
+  printf("  %s -i words.txt -N 500 -j 4 -o puzzles/day\n", pname);
+  printf("  %s compile words.txt -o words.cwd\n", pname);
   printf("\n");
 }
 
+/*
+ * Compile a list of words (see dict.h).
+ * argc : argc, starting at the "compile" command.
+ * argv : argv, starting at the "compile" command.
+ * Returns the exit status of the program.
+ */
+int compile_main(int argc, char** argv){
+  char opt;
+  char* out_name = NULL;
+  int verbose = VERBOSE_OFF;
+  int threads = 1;
+  int lenient = 0;
+  FILE* input;
+  FILE* output;
+  word_list words = NULL;
+
+  // Read arguments.
+  while(-1 != (opt = getopt(argc, argv, "o:j:kv"))){
+    switch(opt){
+    case 'o' :
+      out_name = optarg;
+      break;
+    case 'j' :
+      threads = atoi(optarg);
+      if((threads < 1) || (threads > MAX_THREADS)){
+        fprintf(stderr, "The number of threads must be between 1 and %i...\n",
+                MAX_THREADS);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'k' :
+      lenient = 1;
+      break;
+    case 'v' :
+      verbose = VERBOSE_ON;
+      break;
+    default  :
+      fprintf(stderr, "Unrecognized argument...\n");
+      return EXIT_FAILURE;
+    }
+  }
+  if((optind + 1 != argc) || (NULL == out_name)){
+    fprintf(stderr, "Usage: cwg compile file -o output [-j int] [-k] [-v]\n");
+    return EXIT_FAILURE;
+  }
+
+  // Reading (and checking) the words.
+  if(NULL == (input = fopen(argv[optind], "r"))){
+    fprintf(stderr, "Cannot open the input file (may not exist)...\n");
+    return EXIT_FAILURE;
+  }
+  fscan_words(input, &words, threads, lenient, verbose);
+  fprint_diags(stderr, words);
+  fclose(input);
+
+  // Writing the compiled list.
+  if(NULL == (output = fopen(out_name, "wb"))){
+    fprintf(stderr, "Cannot open the output file...\n");
+    free_words(words);
+    return EXIT_FAILURE;
+  }
+  if((0 != dict_write(output, words)) | (0 != fclose(output))){
+    fprintf(stderr, "Error while writing the compiled list !\n");
+    free_words(words);
+    return EXIT_FAILURE;
+  }
+  if(verbose)
+    fprintf(stderr, "%d words compiled in %s.\n", words->next_free, out_name);
+
+  free_words(words);
+  return EXIT_SUCCESS;
+}
+
+/*
+ * Serve crosswords (see serve.h).
+ * argc : argc, starting at the "serve" command.
+ * argv : argv, starting at the "serve" command.
+ * Returns the exit status of the program.
+ */
+int serve_main(int argc, char** argv){
+  char opt;
+  serve_params p;
+  int lenient = 0;
+  int res = EXIT_SUCCESS;
+  int i;
+  FILE* input;
+
+  p.nb_lists = 0;
+  p.path = NULL;
+  p.nb_threads = 1;
+  p.queue = SERVE_QUEUE;
+  p.verbose = VERBOSE_OFF;
+
+  // Read arguments (the lists are read once all the options are known).
+  while(-1 != (opt = getopt(argc, argv, "i:u:j:q:kv"))){
+    switch(opt){
+    case 'i' :
+      p.nb_lists++;
+      break;
+    case 'u' :
+      p.path = optarg;
+      break;
+    case 'j' :
+      p.nb_threads = atoi(optarg);
+      if((p.nb_threads < 1) || (p.nb_threads > MAX_THREADS)){
+        fprintf(stderr, "The number of threads must be between 1 and %i...\n",
+                MAX_THREADS);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'q' :
+      p.queue = atoi(optarg);
+      if(p.queue < 1){
+        fprintf(stderr, "The queue must hold at least one connection...\n");
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'k' :
+      lenient = 1;
+      break;
+    case 'v' :
+      p.verbose = VERBOSE_ON;
+      break;
+    default  :
+      fprintf(stderr, "Unrecognized argument...\n");
+      return EXIT_FAILURE;
+    }
+  }
+  if((optind != argc) || (0 == p.nb_lists)){
+    fprintf(stderr, "Usage: cwg serve -i file [-i file...] [-u socket] "
+                    "[-j int] [-q int] [-k] [-v]\n");
+    return EXIT_FAILURE;
+  }
+  if(NULL == (p.lists = malloc(p.nb_lists * sizeof(word_list)))){
+    fprintf(stderr, "Malloc error in serve_main !\n");
+    return EXIT_FAILURE;
+  }
+
+  // Reading the lists, in the order of the options.
+  p.nb_lists = 0;
+  optind = 1;
+  while(-1 != (opt = getopt(argc, argv, "i:u:j:q:kv"))){
+    if('i' != opt) continue;
+    if(NULL == (input = fopen(optarg, "r"))){
+      fprintf(stderr, "Cannot open the input file %s (may not exist)...\n",
+              optarg);
+      res = EXIT_FAILURE;
+      break;
+    }
+    fscan_words(input, &p.lists[p.nb_lists], p.nb_threads, lenient,
+                p.verbose);
+    fprint_diags(stderr, p.lists[p.nb_lists]);
+    fclose(input);
+    if(p.verbose)
+      fprintf(stderr, "List %d: %d words from %s.\n", p.nb_lists,
+              p.lists[p.nb_lists]->next_free, optarg);
+    p.nb_lists++;
+  }
+
+  if((EXIT_SUCCESS == res) && (0 != cw_serve(&p))) res = EXIT_FAILURE;
+  for(i = 0; i < p.nb_lists; i++) free_words(p.lists[i]);
+  free(p.lists);
+  return res;
+}
+
+/*
+ * Generate a batch of crosswords (see batch.h).
+ * words    : the list of words.
+ * params   : the parameters of the generations.
+ * manifest : the manifest of the batch, NULL if none.
+ * count    : the number of crosswords (if there is no manifest).
+ * prefix   : the prefix of the output files, NULL for the standard output.
+ * format   : the output format.
+ * verbose  : if set to 1 verbose mode. 0 otherwise.
+ * Returns the exit status of the program.
+ */
+int batch_main(word_list words, gen_params* params, FILE* manifest,
+               int count, char* prefix, int format, int verbose){
+  batch_params b;
+  int res;
+
+  // The crosswords of the batch.
+  if(NULL != manifest){
+    res = batch_read_manifest(manifest, &b.jobs, &b.nb_jobs, params->seed);
+    fclose(manifest);
+  }else{
+    b.nb_jobs = count;
+    res = batch_jobs(&b.jobs, count, params->width, params->height,
+                     params->seed);
+  }
+  if(0 != res) return EXIT_FAILURE;
+
+  // One crossword per thread at a time.
+  b.gen = *params;
+  b.nb_threads = params->nb_threads;
+  b.format = format;
+  b.prefix = prefix;
+  b.verbose = verbose;
+  if(verbose) fprintf(stderr, "Generating %d crosswords...\n", b.nb_jobs);
+  res = cw_batch(words, &b);
+  free(b.jobs);
+  if(0 != res){
+    fprintf(stderr, "Error while generating the batch !\n");
+    return EXIT_FAILURE;
+  }
+  if(verbose) fprintf(stderr, "Done.\n");
+  return EXIT_SUCCESS;
+}
+
 /*
  * Parse command line arguments.
  * argc : argc.
@@ -230,12 +501,29 @@ void display_help(char* pname){
  *        0 default
  *        1 latex
  * nr   : number of runs for the program.
+ * nt   : number of threads.
+ * s    : seed of the random generator (result).
+ * k    : if set to 1 malformed lines of the input are skipped.
+ * a    : algorithm of the runs (see gen.h).
+ * t    : time limit in milliseconds, 0 if none.
+ * o    : weights of the score of the crosswords (see score.h).
+ * nb   : number of crosswords of a batch, 0 if not in batch mode.
+ * m    : manifest of a batch (result), NULL if none.
+ * p    : prefix of the output files of a batch (result), NULL if none.
+ * Returns 1 if a seed was given. 0 otherwise.
  */
-void get_args(int argc, char** argv,
-              FILE** i, int* w, int* h, int* v, int* f, int* nr){
+int get_args(int argc, char** argv, FILE** i, int* w, int* h, int* v, int* f,
+             int* nr, int* nt, unsigned long long* s, int* k, int* a,
+             long* t, score_weights* o, int* nb, FILE** m, char** p){
   char opt;
   int n;
   char* fn;
+  char* end;
+  int seeded = 0;
+  struct option long_opts[] = {
+    {"objective", required_argument, NULL, 'O'},
+    {NULL, 0, NULL, 0}
+  };
 
   // Default options.
   *i = NULL;
@@ -243,6 +531,13 @@ void get_args(int argc, char** argv,
   *h = DEFAULT_HEIGHT;
   *v = VERBOSE_OFF;
   *f = TEXT_FORMAT;
+  *k = 0;
+  *a = ALGO_RANDOM;
+  *t = 0;
+  score_default(o);
+  *nb = 0;
+  *m = NULL;
+  *p = NULL;
 
   // Check for arguments.
   if(1 == argc){
@@ -252,7 +547,8 @@ void get_args(int argc, char** argv,
   }
 
   // Read arguments.
-  while(-1 != (opt = getopt(argc, argv, "i:W:H:n:vlwh"))){
+  while(-1 != (opt = getopt_long(argc, argv, "i:W:H:n:j:s:ka:t:N:m:o:vlwf:h",
+                                  long_opts, NULL))){
     switch(opt){
     case 'i' :
       fn = optarg;
@@ -289,6 +585,69 @@ void get_args(int argc, char** argv,
       }
       *nr = n;
       break;
+    case 'j' :
+      n = atoi(optarg);
+      if((n < 1) || (n > MAX_THREADS)){
+        fprintf(stderr, "The number of threads must be between 1 and %i...\n",
+                MAX_THREADS);
+        exit(EXIT_FAILURE);
+      }
+      *nt = n;
+      break;
+    case 's' :
+      *s = strtoull(optarg, &end, 10);
+      if(('\0' == *optarg) || ('\0' != *end)){
+        fprintf(stderr, "The seed must be a non-negative integer...\n");
+        exit(EXIT_FAILURE);
+      }
+      seeded = 1;
+      break;
+    case 'k' :
+      *k = 1;
+      break;
+    case 'a' :
+      if(0 == strcmp(optarg, "random")){
+        *a = ALGO_RANDOM;
+      }else if(0 == strcmp(optarg, "search")){
+        *a = ALGO_SEARCH;
+      }else if(0 == strcmp(optarg, "anneal")){
+        *a = ALGO_ANNEAL;
+      }else{
+        fprintf(stderr, "The algorithm must be random, search or anneal...\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+    case 't' :
+      *t = strtol(optarg, &end, 10);
+      if(('\0' == *optarg) || ('\0' != *end) || (*t < 1)){
+        fprintf(stderr, "The time limit must be a positive integer...\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+    case 'N' :
+      n = atoi(optarg);
+      if(n < 1){
+        fprintf(stderr, "A batch must have at least one crossword...\n");
+        exit(EXIT_FAILURE);
+      }
+      *nb = n;
+      break;
+    case 'm' :
+      if(NULL == (*m = fopen(optarg, "r"))){
+        fprintf(stderr, "Cannot open the manifest (may not exist)...\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+    case 'o' :
+      *p = optarg;
+      break;
+    case 'O' :
+      if(0 != score_parse(optarg, o)){
+        fprintf(stderr, "The objective must be of the form "
+                        "words=4096,crossings=64,density=0,area=-1...\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
     case 'v' :
       *v = VERBOSE_ON;
       break;
@@ -298,6 +657,12 @@ void get_args(int argc, char** argv,
     case 'w' :
       *f = HTML_FORMAT;
       break;
+    case 'f' :
+      if(-1 == (*f = output_format(optarg))){
+        fprintf(stderr, "The format must be text, latex, html or json...\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
     case 'h' :
       display_help(argv[0]);
       exit(EXIT_SUCCESS);
@@ -312,4 +677,13 @@ void get_args(int argc, char** argv,
     fprintf(stderr, "An input file should be specified...\n");
     exit(EXIT_FAILURE);
   }
+
+  // Batch mode.
+  if((0 != *nb) && (NULL != *m)){
+    fprintf(stderr, "A batch is given by -N or by -m, not both...\n");
+    exit(EXIT_FAILURE);
+  }
+  if((NULL != *p) && (0 == *nb) && (NULL == *m)) *nb = 1;
+
+  return seeded;
 }
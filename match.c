@@ -0,0 +1,59 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** match.c *****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "match.h".                  *
+ ****************************************************************************/
+#include <stdio.h>
+#include "const.h"
+#include "word.h"
+#include "match.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/*
+ * Mask of the n first bytes of a SIMD comparison.
+ */
+#define MATCH_BITS(n) ((1U << (n)) - 1)
+#endif
+
+/*
+ * Tells whether a word matches a pattern. With SSE2 (always there on
+ * x86-64), the whole word is compared in one operation.
+ * w   : the word (WORD_STORAGE bytes are read).
+ * pat : the pattern, EMPTY_CHAR matches any letter (WORD_STORAGE bytes are
+ *       read).
+ * len : the number of characters to compare (at most WORD_STORAGE).
+ * Returns 1 if the len first characters match, 0 otherwise.
+ */
+int match_word(const char* w, const char* pat, int len){
+#ifdef __SSE2__
+  __m128i vw = _mm_loadu_si128((const __m128i*) w);
+  __m128i vp = _mm_loadu_si128((const __m128i*) pat);
+  __m128i ok = _mm_or_si128(_mm_cmpeq_epi8(vw, vp),
+                            _mm_cmpeq_epi8(vp, _mm_set1_epi8(EMPTY_CHAR)));
+
+  return 0 == (~_mm_movemask_epi8(ok) & MATCH_BITS(len));
+#else
+  int k;
+
+  for(k = 0; k < len; k++)
+    if((pat[k] != EMPTY_CHAR) && (pat[k] != w[k])) return 0;
+  return 1;
+#endif
+}
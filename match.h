@@ -0,0 +1,44 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** match.h *****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the function matching words against the pattern of a     *
+ *   slot of the grid (the letters already there, EMPTY_CHAR elsewhere). A  *
+ *   word fits in 16 bytes, so it is compared in one SIMD operation when    *
+ *   SSE2 is available at compile time. There is a portable fallback.       *
+ ****************************************************************************/
+#ifndef __MATCH_H__
+#define __MATCH_H__
+
+#include "const.h"
+#include "word.h"
+
+#if MAX_WORD_SIZE + 1 > WORD_STORAGE
+#error "MAX_WORD_SIZE is too big for the letter matching."
+#endif
+
+/*
+ * Tells whether a word matches a pattern.
+ * w   : the word (WORD_STORAGE bytes are read).
+ * pat : the pattern, EMPTY_CHAR matches any letter (WORD_STORAGE bytes are
+ *       read).
+ * len : the number of characters to compare (at most WORD_STORAGE).
+ * Returns 1 if the len first characters match, 0 otherwise.
+ */
+int match_word(const char* w, const char* pat, int len);
+
+#endif
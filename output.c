@@ -17,477 +17,727 @@
  ** output.c ****************************************************************
  * 31/01/2013               CWG - Crossword generator                       *
  * Content of this file:                                                    *
- *   Implementation of the function defined in "output.c".                  *
+ *   Implementation of the function defined in "output.h".                  *
  * Author: Rodolphe Lepigre <rlepigre@gmail.com>                            *
  ****************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "cw.h"
 #include "const.h"
+#include "buffer.h"
+#include "output.h"
 
 /*
- * Prints a string using a given number of chars.
- *   f : the file where to print the crossword.
+ * Append a string padded with spaces to a given number of chars.
+ *   b : the buffer.
  *   s : the string.
  *   n : the number of chars.
  */
-void print_n_chars(FILE *f, char *s, int n){
+static void render_n_chars(buffer* b, const char* s, int n){
   int len = strlen(s);
-  int i;
 
-  fprintf(f, "%s", s);
+  buf_add(b, s, len);
+  buf_fill(b, ' ', n - len);
+}
 
-  for(i = len; i < n; i++)
-    fprintf(f, " ");
+/*
+ * Append a clue to a buffer.
+ * b  : the buffer.
+ * wl : the list of words.
+ * i  : the index of the word in wl.
+ */
+static void render_clue(buffer* b, word_list wl, int i){
+  buf_add(b, WORD_CLUE(wl, i), WORD_CLUE_LEN(wl, i));
 }
 
 /*
- * Print a crossword.
- * f  : the file where to print the crossword.
- * cw : the crossword. Must be initialized.
+ * Render a crossword as text (the whole grid, then the clues in the order
+ * of placement).
+ * b : the buffer (the text is appended).
+ * l : the layout of the crossword.
  */
-void cw_print(FILE *f, crossword cw){
+static void render_text(buffer* b, output_layout* l){
+  crossword cw = l->cw;
+  word_list wl = l->wl;
   int i, j;
+  char* line;
 
-  // Print the grid
-  fprintf(f, "\n");
-  fprintf(f, "  #");
-  for(i = 0; i < cw->width + 1; i++) fprintf(f, " #");
-  fprintf(f, "\n");
+  // Print the grid, a line is built in place and copied in one go.
+  buf_puts(b, "\n  #");
+  for(i = 0; i < cw->width + 1; i++) buf_puts(b, " #");
+  buf_puts(b, "\n");
   for(i = 0; i < cw->height; i++){
-    fprintf(f, "  #");
-    for(j = 0; j < cw->width; j++){
-      fprintf(f, " %c", cw->grid[j][i]);
-    }
-    fprintf(f, " #\n");
+    buf_puts(b, "  #");
+    buf_fill(b, ' ', 2 * cw->width);
+    if(b->error) return;
+    line = b->data + b->len - 2 * cw->width + 1;
+    for(j = 0; j < cw->width; j++) line[2 * j] = CW_CELL(cw, j, i);
+    buf_puts(b, " #\n");
   }
-  fprintf(f, "  #");
-  for(i = 0; i < cw->width + 1; i++) fprintf(f, " #");
-  fprintf(f, "\n");
+  buf_puts(b, "  #");
+  for(i = 0; i < cw->width + 1; i++) buf_puts(b, " #");
+  buf_puts(b, "\n");
 
   // Print the clues.
-  fprintf(f, "\n");
+  buf_puts(b, "\n");
   for(i = 0; i < cw->nb_words; i++){
-    if(cw->words[i].orient == HORIZONTAL) fprintf(f, "Horiz");
-    else fprintf(f, "Verti");
-    fprintf(f, " (%2d,%2d) ", cw->words[i].posx, cw->words[i].posy);
-    print_n_chars(f, cw->words[i].w.w, MAX_WORD_SIZE);
-    fprintf(f, " : %s\n", cw->words[i].w.d);
+    if(cw->words[i].orient == HORIZONTAL) buf_puts(b, "Horiz");
+    else buf_puts(b, "Verti");
+    buf_printf(b, " (%2d,%2d) ", cw->words[i].posx, cw->words[i].posy);
+    render_n_chars(b, wl->l[cw->words[i].w].w, MAX_WORD_SIZE);
+    buf_puts(b, " : ");
+    render_clue(b, wl, cw->words[i].w);
+    buf_puts(b, "\n");
   }
-  fprintf(f, "\n");
+  buf_puts(b, "\n");
 }
 
 /*
- * Print a crossword in LaTeX mode.
- * cw : the crossword. Must be initialized.
- * Returns 0 if all went well. -1 otherwise.
+ * Append the grid of a crossword in LaTeX (cwpuzzle package).
+ * b    : the buffer.
+ * cw   : the crossword.
+ * xmax : the last column to print.
+ * ymax : the last line to print.
  */
-int cw_print_latex(crossword cw){
-  int i, j, k;
-  int num;
-  int xmax, ymax;
-
-  // Look for real size.
-  xmax = 0;
-  ymax = 0;
-  for(i = 0; i < cw->height; i++)
-    for(j = 0; j < cw->width; j++)
-      if(cw->grid[j][i] != EMPTY_CHAR){
-        if(i > ymax) ymax = i;
-        if(j > xmax) xmax = j;
-      }
+static void render_latex_grid(buffer* b, crossword cw, int xmax, int ymax){
+  int i, j, num;
 
-  // LaTeX header
-  printf("%% Latex document generated by cwg.\n");
-  printf("%% This is free software.\n");
-  printf("%% Author : Rodolphe Lepigre (rlepigre@gmail.com)\n");
-  printf("%% Adapted by Veronica Brandt (veronica@brandt.id.au)\n");
-  printf("\\documentclass[12pt]{article}\n");
-  printf("\\usepackage{cwpuzzle}\n");
-  printf("\\usepackage{libertine}\n");
-  printf("\\usepackage[cm]{fullpage}\n");
-  printf("\\usepackage{fancyhdr}\n");
-  printf("\\begin{document}\n");
-  printf("\\pagestyle{fancy}\n");
-  printf("\\fancyhf{}\n");
-  printf("\\renewcommand{\\headrulewidth}{0pt}\n");
-  printf("\\renewcommand{\\footrulewidth}{0pt}\n");
-  printf("\\fancyfoot[C]{A New Book of Old Hymns --- \\the\\year{} --- www.brandt.id.au}\n");
-  printf("\\libertine\n");
-  printf("\\renewcommand\\PuzzleClueFont{\\rm\\normalsize}\n");
-  printf("\\begin{center}\n");
-  printf("  \\huge{%s}\n", "Crossword Puzzle:"); // TODO allow custom title
-  printf("\\end{center}\n");
-  printf("\\vspace{1.5cm}\n");
-
-  // Print the empty grid
-  printf("\\begin{Puzzle}{%d}{%d}\n", cw->width, cw->height);
+  buf_printf(b, "\\begin{Puzzle}{%d}{%d}\n", cw->width, cw->height);
   for(i = 0; i <= ymax; i++){
-    printf("  |");
+    buf_puts(b, "  |");
     for(j = 0; j <= xmax; j++){
-      if(cw->grid[j][i] == EMPTY_CHAR){
-        printf("{}  |");
-      }else if(cw->grid[j][i] == SPACE_CHAR){
-        printf("*   |");
+      if(CW_CELL(cw, j, i) == EMPTY_CHAR){
+        buf_puts(b, "{}  |");
+      }else if(CW_CELL(cw, j, i) == SPACE_CHAR){
+        buf_puts(b, "*   |");
       }else{
-        num = -1;
-        for(k = 0; k < cw->nb_words; k++)
-          if((cw->words[k].posx == j) && (cw->words[k].posy == i)){
-            num = cw->words[k].label;
-          }
+        num = CW_LABEL(cw, j, i);
         if(-1 == num){
-          printf("%c   |", cw->grid[j][i]);
+          buf_putc(b, CW_CELL(cw, j, i));
+          buf_puts(b, "   |");
         }else{
-          printf("[%d]%c|", num, cw->grid[j][i]);
+          buf_putc(b, '[');
+          buf_int(b, num);
+          buf_putc(b, ']');
+          buf_putc(b, CW_CELL(cw, j, i));
+          buf_putc(b, '|');
         }
       }
     }
-    printf(".\n");
+    buf_puts(b, ".\n");
+  }
+  buf_puts(b, "\\end{Puzzle}\n");
+}
+
+/*
+ * Append clues in LaTeX.
+ * b     : the buffer.
+ * l     : the layout of the crossword.
+ * words : the words (indices in l->cw->words).
+ * nb    : the number of words.
+ */
+static void render_latex_clues(buffer* b, output_layout* l, int* words,
+                               int nb){
+  placed_word* w;
+  int i;
+
+  for(i = 0; i < nb; i++){
+    w = &l->cw->words[words[i]];
+    buf_puts(b, "  \\Clue{");
+    buf_int(b, w->label);
+    buf_puts(b, "}{");
+    buf_puts(b, l->wl->l[w->w].w);
+    buf_puts(b, "}{");
+    render_clue(b, l->wl, w->w);
+    buf_puts(b, "}\n");
   }
-  printf("\\end{Puzzle}\n");
+}
+
+/*
+ * Render a crossword in LaTeX mode.
+ * b : the buffer (the document is appended).
+ * l : the layout of the crossword.
+ */
+static void render_latex(buffer* b, output_layout* l){
+  crossword cw = l->cw;
+
+  // Real size (the grid starts at the top left corner).
+  int xmax = (l->xmax < 0) ? 0 : l->xmax;
+  int ymax = (l->ymax < 0) ? 0 : l->ymax;
+
+  // LaTeX header
+  buf_puts(b, "% Latex document generated by cwg.\n");
+  buf_puts(b, "% This is free software.\n");
+  buf_puts(b, "% Author : Rodolphe Lepigre (rlepigre@gmail.com)\n");
+  buf_puts(b, "% Adapted by Veronica Brandt (veronica@brandt.id.au)\n");
+  buf_puts(b, "\\documentclass[12pt]{article}\n");
+  buf_puts(b, "\\usepackage{cwpuzzle}\n");
+  buf_puts(b, "\\usepackage{libertine}\n");
+  buf_puts(b, "\\usepackage[cm]{fullpage}\n");
+  buf_puts(b, "\\usepackage{fancyhdr}\n");
+  buf_puts(b, "\\begin{document}\n");
+  buf_puts(b, "\\pagestyle{fancy}\n");
+  buf_puts(b, "\\fancyhf{}\n");
+  buf_puts(b, "\\renewcommand{\\headrulewidth}{0pt}\n");
+  buf_puts(b, "\\renewcommand{\\footrulewidth}{0pt}\n");
+  buf_puts(b, "\\fancyfoot[C]{A New Book of Old Hymns --- \\the\\year{} --- www.brandt.id.au}\n");
+  buf_puts(b, "\\libertine\n");
+  buf_puts(b, "\\renewcommand\\PuzzleClueFont{\\rm\\normalsize}\n");
+  buf_puts(b, "\\begin{center}\n");
+  buf_printf(b, "  \\huge{%s}\n", "Crossword Puzzle:"); // TODO allow custom title
+  buf_puts(b, "\\end{center}\n");
+  buf_puts(b, "\\vspace{1.5cm}\n");
+
+  // Print the empty grid
+  render_latex_grid(b, cw, xmax, ymax);
 
   // Print the clues
-  printf("\\begin{PuzzleClues}{\\textbf{Across:}}\n");
-  for(i = 0; i < cw->nb_words; i++)
-    if(cw->words[i].orient == HORIZONTAL){
-      printf("  \\Clue{%d}{%s}{%s}\n", cw->words[i].label,
-             cw->words[i].w.w, cw->words[i].w.d);
-    }
-  printf("\\end{PuzzleClues}\n");
-  printf("\\begin{PuzzleClues}{\\textbf{Down:}}\n");
-  for(i = 0; i < cw->nb_words; i++)
-    if(cw->words[i].orient == VERTICAL){
-      printf("  \\Clue{%d}{%s}{%s}\n", cw->words[i].label,
-             cw->words[i].w.w, cw->words[i].w.d);
-    }
-  printf("\\end{PuzzleClues}\n");
+  buf_puts(b, "\\begin{PuzzleClues}{\\textbf{Across:}}\n");
+  render_latex_clues(b, l, l->across, l->nb_across);
+  buf_puts(b, "\\end{PuzzleClues}\n");
+  buf_puts(b, "\\begin{PuzzleClues}{\\textbf{Down:}}\n");
+  render_latex_clues(b, l, l->down, l->nb_down);
+  buf_puts(b, "\\end{PuzzleClues}\n");
 
   // Print the solution on a new page.
-  printf("\\newpage\n");
-  printf("\\begin{center}\n");
-  printf("  \\huge{%s - Solution}\n", "Crossword Puzzle:"); // TODO allow custom title
-  printf("\\end{center}\n");
-  printf("\\vspace{1.5cm}\n");
-  printf("\\PuzzleSolution\n");
-  printf("\\begin{Puzzle}{%d}{%d}\n", cw->width, cw->height);
-  for(i = 0; i <= ymax; i++){
-    printf("  |");
-    for(j = 0; j <= xmax; j++){
-      if(cw->grid[j][i] == EMPTY_CHAR){
-        printf("{}  |");
-      }else if(cw->grid[j][i] == SPACE_CHAR){
-        printf("*   |");
-      }else{
-        num = -1;
-        for(k = 0; k < cw->nb_words; k++)
-          if((cw->words[k].posx == j) && (cw->words[k].posy == i)){
-            num = cw->words[k].label;
-          }
-        if(-1 == num){
-          printf("%c   |", cw->grid[j][i]);
-        }else{
-          printf("[%d]%c|", num, cw->grid[j][i]);
-        }
-      }
-    }
-    printf(".\n");
-  }
-  printf("\\end{Puzzle}\n");
+  buf_puts(b, "\\newpage\n");
+  buf_puts(b, "\\begin{center}\n");
+  buf_printf(b, "  \\huge{%s - Solution}\n", "Crossword Puzzle:"); // TODO allow custom title
+  buf_puts(b, "\\end{center}\n");
+  buf_puts(b, "\\vspace{1.5cm}\n");
+  buf_puts(b, "\\PuzzleSolution\n");
+  render_latex_grid(b, cw, xmax, ymax);
 
   // Document footer
-  printf("\\end{document}\n");
-  return 0;
+  buf_puts(b, "\\end{document}\n");
 }
 
 /*
- * Print a crossword in HTML mode.
- * cw : the crossword. Must be initialized.
- * Returns 0 if all went well. -1 otherwise.
+ * Append clues in HTML (list items).
+ * b     : the buffer.
+ * l     : the layout of the crossword.
+ * words : the words (indices in l->cw->words).
+ * nb    : the number of words.
  */
-int cw_print_html(crossword cw){
-  int i, j, k, c;
+static void render_html_clues(buffer* b, output_layout* l, int* words,
+                              int nb){
+  placed_word* w;
+  int i;
 
-  int xmin = cw->width;
-  int xmax = 0;
-  int ymin = cw->height;
-  int ymax = 0;
+  for(i = 0; i < nb; i++){
+    w = &l->cw->words[words[i]];
+    buf_puts(b, "\t\t\t\t\t<li>");
+    buf_int(b, w->label);
+    buf_puts(b, " - ");
+    render_clue(b, l->wl, w->w);
+    buf_puts(b, "</li>\n");
+  }
+}
 
-  int num;
+/*
+ * Render a crossword in HTML mode (the grid is cut to its letters).
+ * b : the buffer (the document is appended).
+ * l : the layout of the crossword.
+ */
+static void render_html(buffer* b, output_layout* l){
+  crossword cw = l->cw;
+  int i, j, c;
 
-  for(i = 0; i < cw->height; i++)
-    for(j = 0; j < cw->width; j++)
-      if(cw->grid[j][i] != EMPTY_CHAR){
-        if(i < ymin) ymin = i;
-        if(i > ymax) ymax = i;
-        if(j < xmin) xmin = j;
-        if(j > xmax) xmax = j;
-      }
+  int xmin = l->xmin;
+  int xmax = l->xmax;
+  int ymin = l->ymin;
+  int ymax = l->ymax;
+
+  int num;
 
   // Header
-  printf("<!DOCTYPE html>\n");
-  printf("<html>\n");
-  printf("<head>\n");
-  printf("\t<title>Crossword</title>\n");
-  printf("\t<meta http-equiv=\"Content-Type\"" \
-         " content=\"text/html; charset=utf-8\"/>\n");
+  buf_puts(b, "<!DOCTYPE html>\n");
+  buf_puts(b, "<html>\n");
+  buf_puts(b, "<head>\n");
+  buf_puts(b, "\t<title>Crossword</title>\n");
+  buf_puts(b, "\t<meta http-equiv=\"Content-Type\"" \
+          " content=\"text/html; charset=utf-8\"/>\n");
   // CSS
-  printf("\t<style>\n");
-  printf("\t\t#layout {\n");
-  printf("\t\t\twidth : 90%%;\n");
-  printf("\t\t\tborder : 1px solid black;\n");
-  printf("\t\t\tborder-collapse : collapse;\n");
-  printf("\t\t\tmargin : auto;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.crossword {\n");
-  /* printf("\t\t\tborder : 1px solid black;\n"); */
-  printf("\t\t\tmargin : auto;\n");
-  printf("\t\t\tmargin-top : 20px;\n");
-  printf("\t\t\tborder-collapse : collapse;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.crossword tr td {\n");
-  printf("\t\t\twidth : 30px;\n");
-  printf("\t\t\theight : 30px;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.letter {\n");
-  printf("\t\t\tborder : 1px solid black;\n");
-  printf("\t\t\tbackground-color : white;\n");
-  printf("\t\t\ttext-align : center;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.num {\n");
-  printf("\t\t\tfont-size : 8px;\n");
-  printf("\t\t\twidth : 0px;\n");
-  printf("\t\t\theight : 0px;\n");
-  printf("\t\t\tposition : relative;\n");
-  printf("\t\t\ttop : -6px;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.clues {\n");
-  printf("\t\t\tborder : 1px solid black;\n");
-  printf("\t\t\tborder-collapse : collapse;\n");
-  printf("\t\t\twidth : 90%%;\n");
-  printf("\t\t\tmargin : auto;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.clues td {\n");
-  printf("\t\t\tborder : 1px solid black;\n");
-  printf("\t\t\tvertical-align: top;\n");
-  printf("\t\t\twidth : 45%%;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.clues td h2 {\n");
-  printf("\t\t\ttext-align: center;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.clues td ul {\n");
-  printf("\t\t\tlist-style-type : none;\n");
-  printf("\t\t\tpadding : 8px 8px 8px 8px;\n");
-  printf("\t\t\ttext-align : justify;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.empty {\n");
-  printf("\t\t\tbackground-color : white;\n");
-  /* printf("\t\t\tbackground-color : black;\n"); */
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.dark {\n");
-  printf("\t\t\tbackground-color : black;\n");
-  /* printf("\t\t\tbackground-color : white;\n"); */
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\t.center {\n");
-  printf("\t\t\ttext-align : center;\n");
-  printf("\t\t}\n");
-  printf("\t</style>\n");
+  buf_puts(b, "\t<style>\n");
+  buf_puts(b, "\t\t#layout {\n");
+  buf_puts(b, "\t\t\twidth : 90%;\n");
+  buf_puts(b, "\t\t\tborder : 1px solid black;\n");
+  buf_puts(b, "\t\t\tborder-collapse : collapse;\n");
+  buf_puts(b, "\t\t\tmargin : auto;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.crossword {\n");
+  /* buf_puts(b, "\t\t\tborder : 1px solid black;\n"); */
+  buf_puts(b, "\t\t\tmargin : auto;\n");
+  buf_puts(b, "\t\t\tmargin-top : 20px;\n");
+  buf_puts(b, "\t\t\tborder-collapse : collapse;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.crossword tr td {\n");
+  buf_puts(b, "\t\t\twidth : 30px;\n");
+  buf_puts(b, "\t\t\theight : 30px;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.letter {\n");
+  buf_puts(b, "\t\t\tborder : 1px solid black;\n");
+  buf_puts(b, "\t\t\tbackground-color : white;\n");
+  buf_puts(b, "\t\t\ttext-align : center;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.num {\n");
+  buf_puts(b, "\t\t\tfont-size : 8px;\n");
+  buf_puts(b, "\t\t\twidth : 0px;\n");
+  buf_puts(b, "\t\t\theight : 0px;\n");
+  buf_puts(b, "\t\t\tposition : relative;\n");
+  buf_puts(b, "\t\t\ttop : -6px;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.clues {\n");
+  buf_puts(b, "\t\t\tborder : 1px solid black;\n");
+  buf_puts(b, "\t\t\tborder-collapse : collapse;\n");
+  buf_puts(b, "\t\t\twidth : 90%;\n");
+  buf_puts(b, "\t\t\tmargin : auto;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.clues td {\n");
+  buf_puts(b, "\t\t\tborder : 1px solid black;\n");
+  buf_puts(b, "\t\t\tvertical-align: top;\n");
+  buf_puts(b, "\t\t\twidth : 45%;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.clues td h2 {\n");
+  buf_puts(b, "\t\t\ttext-align: center;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.clues td ul {\n");
+  buf_puts(b, "\t\t\tlist-style-type : none;\n");
+  buf_puts(b, "\t\t\tpadding : 8px 8px 8px 8px;\n");
+  buf_puts(b, "\t\t\ttext-align : justify;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.empty {\n");
+  buf_puts(b, "\t\t\tbackground-color : white;\n");
+  /* buf_puts(b, "\t\t\tbackground-color : black;\n"); */
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.dark {\n");
+  buf_puts(b, "\t\t\tbackground-color : black;\n");
+  /* buf_puts(b, "\t\t\tbackground-color : white;\n"); */
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\t.center {\n");
+  buf_puts(b, "\t\t\ttext-align : center;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\t</style>\n");
   // Javascript
-  printf("\t<script>\n");
-  printf("\t\tvar res = [ ");
+  buf_puts(b, "\t<script>\n");
+  buf_puts(b, "\t\tvar res = [ ");
   c = 0;
   for(i = ymin; i <= ymax; i++){
     for(j = xmin; j <= xmax; j++)
-      if(cw->grid[j][i] != EMPTY_CHAR){
-        if(0 == c) printf("\"%c\"", cw->grid[j][i]);
-	else printf(", \"%c\"", cw->grid[j][i]);
+      if(CW_CELL(cw, j, i) != EMPTY_CHAR){
+        if(0 != c) buf_puts(b, ", ");
+        buf_putc(b, '"');
+        buf_putc(b, CW_CELL(cw, j, i));
+        buf_putc(b, '"');
 	c++;
-	if(c % 12 == 0) printf("\n\t\t          ");
+	if(c % 12 == 0) buf_puts(b, "\n\t\t          ");
       }
   }
-  printf("];\n");
-  printf("\n");
+  buf_puts(b, "];\n");
+  buf_puts(b, "\n");
 
-  printf("\t\tvar num = [ ");
+  buf_puts(b, "\t\tvar num = [ ");
   c = 0;
   for(i = ymin; i <= ymax; i++){
     for(j = xmin; j <= xmax; j++)
-      if(cw->grid[j][i] != EMPTY_CHAR){
-        num = -1;
-        for(k = 0; k < cw->nb_words; k++)
-          if((cw->words[k].posx == j) && (cw->words[k].posy == i))
-            num = cw->words[k].label;
-	if(0 == c) printf("%i", num);
-	else printf(", %i", num);
+      if(CW_CELL(cw, j, i) != EMPTY_CHAR){
+        num = CW_LABEL(cw, j, i);
+	if(0 != c) buf_puts(b, ", ");
+	buf_int(b, num);
 	c++;
-	if(c % 12 == 0) printf("\n\t\t          ");
+	if(c % 12 == 0) buf_puts(b, "\n\t\t          ");
       }
   }
-  printf("];\n");
-  printf("\n");
-
-  printf("\t\tvar locked = new Array();\n");
-  printf("\t\tfor(i = 0; i < res.length; i++) locked[i] = false;\n");
-  printf("\n");
-  printf("\t\tvar selected = null;\n");
-  printf("\t\tvar selecnum = -1;\n");
-  printf("\n");
-  printf("\t\tfunction clickfun(o, i){\n");
-  printf("\t\t\tif(selected != null) selected.style.backgroundColor = " \
-         " \"white\";\n");
-  printf("\t\t\tselected = null;\n");
-  printf("\t\t\tselecnum = -1;\n");
-  printf("\t\t\tif(!locked[i]){\n");
-  printf("\t\t\t\tselected = o;\n");
-  printf("\t\t\t\tselecnum = i;\n");
-  printf("\t\t\t\to.style.backgroundColor = \"#DDDDDD\";\n"),
-  printf("\t\t\t}\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\tfunction setletter(e){\n");
-  printf("\t\t\tif(selected != null){\n");
-  printf("\t\t\t\tcode = e.charCode;\n");
-  printf("\t\t\t\tif(code >= 97) code = code - 97 + 65;\n");
-  printf("\t\t\t\tif(code >= 65 && code <= 90){\n");
-  printf("\t\t\t\t\tif(num[selecnum] == -1)\n");
-  printf("\t\t\t\t\t\tselected.innerHTML = String.fromCharCode(code);\n");
-  printf("\t\t\t\t\telse\n");
-  printf("\t\t\t\t\t\tselected.innerHTML = \"<div class=\\\"num\\\">\" + num[selecnum]\n");
-  printf("\t\t\t\t\t\t\t+ \"</div>\" + String.fromCharCode(code);\n");
-  printf("\t\t\t\t\tselected.style.backgroundColor = \"white\";\n");
-  printf("\t\t\t\t\tselected = null;\n");
-  printf("\t\t\t\t\tselecnum = -1;\n");
-  printf("\t\t\t\t}\n");
-  printf("\t\t\t}\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\tfunction docheck(){\n");
-  printf("\t\t\tfor(i = 0; i < res.length; i++){\n");
-  printf("\t\t\t\tstr = document.getElementById('l' + i).innerHTML;\n");
-  printf("\t\t\t\tif(str != \"\" && str != \"<div class=\\\"num\\\">\" + num[i] + \"</div>\"){\n");
-  printf("\t\t\t\t\tif(str == res[i] || str == \"<div class=\\\"num\\\">\" + num[i] + \"</div>\" + res[i]){\n");
-  printf("\t\t\t\t\t\tlocked[i] = true;\n");
-  printf("\t\t\t\t\t\tdocument.getElementById('l' + i).style" \
-         ".backgroundColor = \"#00DD00\"\n");
-  printf("\t\t\t\t\t} else {\n");
-  printf("\t\t\t\t\t\tdocument.getElementById('l' + i).style" \
-         ".backgroundColor = \"#DD0000\"\n");
-  printf("\t\t\t\t\t}\n");
-  printf("\t\t\t\t}\n");
-  printf("\t\t\t}\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\tfunction solve(){\n");
-  printf("\t\t\tfor(i = 0; i < res.length; i++){\n");
-  printf("\t\t\t\tif(num[i] == -1)\n");
-  printf("\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = res[i];\n");
-  printf("\t\t\t\telse\n");
-  printf("\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = \"<div class=\\\"num\\\">\"\n");
-  printf("\t\t\t\t\t\t+ num[i] + \"</div>\" + res[i]\n");
-  printf("\t\t\t\tdocument.getElementById('l' + i).style" \
-         ".backgroundColor = \"#00DD00\"\n");
-  printf("\t\t\t}\n");
-  printf("\t\t\tselected = null;\n");
-  printf("\t\t\tselecnum = -1;\n");
-  printf("\t\t}\n");
-  printf("\n");
-  printf("\t\tfunction reinit(){\n");
-  printf("\t\t\tfor(i = 0; i < res.length; i++){\n");
-  printf("\t\t\t\tif(num[i] == -1)\n");
-  printf("\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = \"\";\n");
-  printf("\t\t\t\telse\n");
-  printf("\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = \"<div class=\\\"num\\\">\"\n");
-  printf("\t\t\t\t\t\t+ num[i] + \"</div>\"\n");
-  printf("\t\t\t\tdocument.getElementById('l' + i).style" \
-         ".backgroundColor = \"white\"\n");
-  printf("\t\t\t\tlocked[i] = false;\n");
-  printf("\t\t\t}\n");
-  printf("\t\t\tselected = null;\n");
-  printf("\t\t\tselecnum = -1;\n");
-  printf("\t\t}\n");
-  printf("\t</script>\n");
+  buf_puts(b, "];\n");
+  buf_puts(b, "\n");
+
+  buf_puts(b, "\t\tvar locked = new Array();\n");
+  buf_puts(b, "\t\tfor(i = 0; i < res.length; i++) locked[i] = false;\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\tvar selected = null;\n");
+  buf_puts(b, "\t\tvar selecnum = -1;\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\tfunction clickfun(o, i){\n");
+  buf_puts(b, "\t\t\tif(selected != null) selected.style.backgroundColor = " \
+          " \"white\";\n");
+  buf_puts(b, "\t\t\tselected = null;\n");
+  buf_puts(b, "\t\t\tselecnum = -1;\n");
+  buf_puts(b, "\t\t\tif(!locked[i]){\n");
+  buf_puts(b, "\t\t\t\tselected = o;\n");
+  buf_puts(b, "\t\t\t\tselecnum = i;\n");
+  buf_puts(b, "\t\t\t\to.style.backgroundColor = \"#DDDDDD\";\n");
+  buf_puts(b, "\t\t\t}\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\tfunction setletter(e){\n");
+  buf_puts(b, "\t\t\tif(selected != null){\n");
+  buf_puts(b, "\t\t\t\tcode = e.charCode;\n");
+  buf_puts(b, "\t\t\t\tif(code >= 97) code = code - 97 + 65;\n");
+  buf_puts(b, "\t\t\t\tif(code >= 65 && code <= 90){\n");
+  buf_puts(b, "\t\t\t\t\tif(num[selecnum] == -1)\n");
+  buf_puts(b, "\t\t\t\t\t\tselected.innerHTML = String.fromCharCode(code);\n");
+  buf_puts(b, "\t\t\t\t\telse\n");
+  buf_puts(b, "\t\t\t\t\t\tselected.innerHTML = \"<div class=\\\"num\\\">\" + num[selecnum]\n");
+  buf_puts(b, "\t\t\t\t\t\t\t+ \"</div>\" + String.fromCharCode(code);\n");
+  buf_puts(b, "\t\t\t\t\tselected.style.backgroundColor = \"white\";\n");
+  buf_puts(b, "\t\t\t\t\tselected = null;\n");
+  buf_puts(b, "\t\t\t\t\tselecnum = -1;\n");
+  buf_puts(b, "\t\t\t\t}\n");
+  buf_puts(b, "\t\t\t}\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\tfunction docheck(){\n");
+  buf_puts(b, "\t\t\tfor(i = 0; i < res.length; i++){\n");
+  buf_puts(b, "\t\t\t\tstr = document.getElementById('l' + i).innerHTML;\n");
+  buf_puts(b, "\t\t\t\tif(str != \"\" && str != \"<div class=\\\"num\\\">\" + num[i] + \"</div>\"){\n");
+  buf_puts(b, "\t\t\t\t\tif(str == res[i] || str == \"<div class=\\\"num\\\">\" + num[i] + \"</div>\" + res[i]){\n");
+  buf_puts(b, "\t\t\t\t\t\tlocked[i] = true;\n");
+  buf_puts(b, "\t\t\t\t\t\tdocument.getElementById('l' + i).style" \
+          ".backgroundColor = \"#00DD00\"\n");
+  buf_puts(b, "\t\t\t\t\t} else {\n");
+  buf_puts(b, "\t\t\t\t\t\tdocument.getElementById('l' + i).style" \
+          ".backgroundColor = \"#DD0000\"\n");
+  buf_puts(b, "\t\t\t\t\t}\n");
+  buf_puts(b, "\t\t\t\t}\n");
+  buf_puts(b, "\t\t\t}\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\tfunction solve(){\n");
+  buf_puts(b, "\t\t\tfor(i = 0; i < res.length; i++){\n");
+  buf_puts(b, "\t\t\t\tif(num[i] == -1)\n");
+  buf_puts(b, "\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = res[i];\n");
+  buf_puts(b, "\t\t\t\telse\n");
+  buf_puts(b, "\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = \"<div class=\\\"num\\\">\"\n");
+  buf_puts(b, "\t\t\t\t\t\t+ num[i] + \"</div>\" + res[i]\n");
+  buf_puts(b, "\t\t\t\tdocument.getElementById('l' + i).style" \
+          ".backgroundColor = \"#00DD00\"\n");
+  buf_puts(b, "\t\t\t}\n");
+  buf_puts(b, "\t\t\tselected = null;\n");
+  buf_puts(b, "\t\t\tselecnum = -1;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\n");
+  buf_puts(b, "\t\tfunction reinit(){\n");
+  buf_puts(b, "\t\t\tfor(i = 0; i < res.length; i++){\n");
+  buf_puts(b, "\t\t\t\tif(num[i] == -1)\n");
+  buf_puts(b, "\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = \"\";\n");
+  buf_puts(b, "\t\t\t\telse\n");
+  buf_puts(b, "\t\t\t\t\tdocument.getElementById('l' + i).innerHTML = \"<div class=\\\"num\\\">\"\n");
+  buf_puts(b, "\t\t\t\t\t\t+ num[i] + \"</div>\"\n");
+  buf_puts(b, "\t\t\t\tdocument.getElementById('l' + i).style" \
+          ".backgroundColor = \"white\"\n");
+  buf_puts(b, "\t\t\t\tlocked[i] = false;\n");
+  buf_puts(b, "\t\t\t}\n");
+  buf_puts(b, "\t\t\tselected = null;\n");
+  buf_puts(b, "\t\t\tselecnum = -1;\n");
+  buf_puts(b, "\t\t}\n");
+  buf_puts(b, "\t</script>\n");
 
   // Body, crosswords
-  printf("</head>\n");
-  printf("<body onkeypress=\"setletter(event);\">\n");
-  printf("\t<table id=\"layout\">\n");
-  printf("\t\t<tr>\n");
-  printf("\t\t\t<td colspan=\"2\">\n");
-  printf("\t\t\t\t<table class=\"crossword\">\n");
+  buf_puts(b, "</head>\n");
+  buf_puts(b, "<body onkeypress=\"setletter(event);\">\n");
+  buf_puts(b, "\t<table id=\"layout\">\n");
+  buf_puts(b, "\t\t<tr>\n");
+  buf_puts(b, "\t\t\t<td colspan=\"2\">\n");
+  buf_puts(b, "\t\t\t\t<table class=\"crossword\">\n");
   c = 0;
   for(i = ymin; i <= ymax; i++){
-    printf("\t\t\t\t\t<tr>\n");
+    buf_puts(b, "\t\t\t\t\t<tr>\n");
 
     for(j = xmin; j <= xmax; j++){
-      printf("\t\t\t\t\t\t<td class=\"");
+      buf_puts(b, "\t\t\t\t\t\t<td class=\"");
 
-      if(cw->grid[j][i] == SPACE_CHAR){
-        printf("dark\"");
+      if(CW_CELL(cw, j, i) == SPACE_CHAR){
+        buf_puts(b, "dark\"");
         // TODO
-      }else if(cw->grid[j][i] != EMPTY_CHAR){
+      }else if(CW_CELL(cw, j, i) != EMPTY_CHAR){
         // Check if the cell is the first letter of a word...
-        num = -1;
-        for(k = 0; k < cw->nb_words; k++)
-          if((cw->words[k].posx == j) && (cw->words[k].posy == i)){
-            num = cw->words[k].label;
-          }
-
-        printf("letter\" id=\"l%i\" onclick=\"clickfun(this, %i);\">", c, c);
-        if(-1 != num) printf("<div class=\"num\">%i</div>", num);
+        num = CW_LABEL(cw, j, i);
+
+        buf_puts(b, "letter\" id=\"l");
+        buf_int(b, c);
+        buf_puts(b, "\" onclick=\"clickfun(this, ");
+        buf_int(b, c);
+        buf_puts(b, ");\">");
+        if(-1 != num){
+          buf_puts(b, "<div class=\"num\">");
+          buf_int(b, num);
+          buf_puts(b, "</div>");
+        }
 	      c++;
       } else {
-        printf("empty\">");
+        buf_puts(b, "empty\">");
       }
 
-      printf("</td>\n");
+      buf_puts(b, "</td>\n");
     }
 
-    printf("\t\t\t\t\t</tr>\n");
+    buf_puts(b, "\t\t\t\t\t</tr>\n");
   }
-  printf("\t\t\t\t</table>\n");
-  printf("\t\t\t\t<p class=\"center\">\n");
-  printf("\t\t\t\t\t<input type=\"button\" value=\"Check\"" \
-         "onclick=\"docheck();\"/>\n");
-  printf("\t\t\t\t\t<input type=\"button\" value=\"Solve\"" \
-         "onclick=\"solve();\"/>\n");
-  printf("\t\t\t\t\t<input type=\"button\" value=\"Reinit\"" \
-         "onclick=\"reinit();\"/>\n");
-  printf("\t\t\t\t</p>\n");
-  printf("\t\t\t</td>\n");
-  printf("\t\t</tr>\n");
+  buf_puts(b, "\t\t\t\t</table>\n");
+  buf_puts(b, "\t\t\t\t<p class=\"center\">\n");
+  buf_puts(b, "\t\t\t\t\t<input type=\"button\" value=\"Check\"" \
+          "onclick=\"docheck();\"/>\n");
+  buf_puts(b, "\t\t\t\t\t<input type=\"button\" value=\"Solve\"" \
+          "onclick=\"solve();\"/>\n");
+  buf_puts(b, "\t\t\t\t\t<input type=\"button\" value=\"Reinit\"" \
+          "onclick=\"reinit();\"/>\n");
+  buf_puts(b, "\t\t\t\t</p>\n");
+  buf_puts(b, "\t\t\t</td>\n");
+  buf_puts(b, "\t\t</tr>\n");
 
   // Body clues.
-  printf("\t\t<tr class=\"clues\">\n");
-  printf("\t\t\t<td>\n");
-  printf("\t\t\t\t<h2>Across</h2>\n");
-  printf("\t\t\t\t<ul>\n");
+  buf_puts(b, "\t\t<tr class=\"clues\">\n");
+  buf_puts(b, "\t\t\t<td>\n");
+  buf_puts(b, "\t\t\t\t<h2>Across</h2>\n");
+  buf_puts(b, "\t\t\t\t<ul>\n");
+  render_html_clues(b, l, l->across, l->nb_across);
+  buf_puts(b, "\t\t\t\t</ul>\n");
+  buf_puts(b, "\t\t\t</td>\n");
+  buf_puts(b, "\t\t\t<td>\n");
+  buf_puts(b, "\t\t\t\t<h2>Down</h2>\n");
+  buf_puts(b, "\t\t\t\t<ul>\n");
+  render_html_clues(b, l, l->down, l->nb_down);
+  buf_puts(b, "\t\t\t\t</ul>\n");
+  buf_puts(b, "\t\t\t</td>\n");
+  buf_puts(b, "\t\t</tr>\n");
+  buf_puts(b, "\t</table>\n");
+  buf_puts(b, "</body>\n");
+  buf_puts(b, "</html>\n");
+}
+
+/*
+ * Append a string in JSON (quoted and escaped).
+ * b : the buffer.
+ * s : the string (may not be terminated by a null char).
+ * n : the length of the string.
+ */
+static void render_json_string(buffer* b, const char* s, int n){
+  const char* hex = "0123456789abcdef";
+  int i, k;
+
+  buf_putc(b, '"');
+  for(i = 0, k = 0; i < n; i++){
+    if(((unsigned char) s[i] >= 0x20) && ('"' != s[i]) && ('\\' != s[i]))
+      continue;
+
+    // The chars up to this one are copied at once.
+    buf_add(b, s + k, i - k);
+    k = i + 1;
+    buf_putc(b, '\\');
+    if((unsigned char) s[i] >= 0x20){
+      buf_putc(b, s[i]);
+    }else{
+      buf_puts(b, "u00");
+      buf_putc(b, hex[(unsigned char) s[i] >> 4]);
+      buf_putc(b, hex[s[i] & 0xf]);
+    }
+  }
+  buf_add(b, s + k, n - k);
+  buf_putc(b, '"');
+}
+
+/*
+ * Append words in JSON (an array of objects).
+ * b     : the buffer.
+ * l     : the layout of the crossword.
+ * words : the words (indices in l->cw->words).
+ * nb    : the number of words.
+ */
+static void render_json_words(buffer* b, output_layout* l, int* words,
+                              int nb){
+  placed_word* w;
+  int i;
+
+  buf_putc(b, '[');
+  for(i = 0; i < nb; i++){
+    w = &l->cw->words[words[i]];
+    buf_puts(b, (0 == i) ? "\n    " : ",\n    ");
+    buf_puts(b, "{\"label\": ");
+    buf_int(b, w->label);
+    buf_puts(b, ", \"x\": ");
+    buf_int(b, w->posx);
+    buf_puts(b, ", \"y\": ");
+    buf_int(b, w->posy);
+    buf_puts(b, ", \"answer\": ");
+    render_json_string(b, l->wl->l[w->w].w, l->wl->l[w->w].len);
+    buf_puts(b, ", \"clue\": ");
+    render_json_string(b, WORD_CLUE(l->wl, w->w), WORD_CLUE_LEN(l->wl, w->w));
+    buf_putc(b, '}');
+  }
+  buf_puts(b, (0 == nb) ? "]" : "\n  ]");
+}
+
+/*
+ * Render a crossword in JSON: the size, the lines of the whole grid (see
+ * CW_CELL), then the across and down words with their positions.
+ * b : the buffer (the document is appended).
+ * l : the layout of the crossword.
+ */
+static void render_json(buffer* b, output_layout* l){
+  crossword cw = l->cw;
+  int i;
+
+  buf_puts(b, "{\n  \"width\": ");
+  buf_int(b, cw->width);
+  buf_puts(b, ",\n  \"height\": ");
+  buf_int(b, cw->height);
+  buf_puts(b, ",\n  \"grid\": [");
+  for(i = 0; i < cw->height; i++){
+    buf_puts(b, (0 == i) ? "\n    " : ",\n    ");
+    render_json_string(b, &CW_CELL(cw, 0, i), cw->width);
+  }
+  buf_puts(b, "\n  ],\n  \"across\": ");
+  render_json_words(b, l, l->across, l->nb_across);
+  buf_puts(b, ",\n  \"down\": ");
+  render_json_words(b, l, l->down, l->nb_down);
+  buf_puts(b, "\n}\n");
+}
+
+/*
+ * The output backends, indexed by format.
+ */
+const output_backend output_backends[NB_FORMATS] = {
+  { "text",  "text",  ".txt",  render_text  },
+  { "latex", "LaTeX", ".tex",  render_latex },
+  { "html",  "HTML",  ".html", render_html  },
+  { "json",  "JSON",  ".json", render_json  }
+};
+
+/*
+ * Find a format from its name.
+ * name : the name (e.g. "latex").
+ * Returns the format, -1 if there is none with this name.
+ */
+int output_format(const char* name){
+  int i;
+
+  for(i = 0; i < NB_FORMATS; i++)
+    if(0 == strcmp(name, output_backends[i].name)) return i;
+  return -1;
+}
+
+/*
+ * Compute the layout of a crossword.
+ * l  : the layout (result).
+ * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int output_layout_init(output_layout* l, crossword cw, word_list wl){
+  int i;
+
+  l->cw = cw;
+  l->wl = wl;
+
+  // The bounding box is maintained by the crossword (see cw_add_word).
+  l->xmin = cw->xmin;
+  l->ymin = cw->ymin;
+  l->xmax = cw->xmax;
+  l->ymax = cw->ymax;
+
+  // The words of each orientation, in a single array.
+  l->nb_across = 0;
+  l->nb_down = 0;
+  if(NULL == (l->across = malloc((cw->nb_words + 1) * sizeof(int)))){
+    fprintf(stderr, "Malloc error in output_layout_init !\n");
+    return -1;
+  }
   for(i = 0; i < cw->nb_words; i++)
-    if(cw->words[i].orient == HORIZONTAL)
-      printf("\t\t\t\t\t<li>%i - %s</li>\n", cw->words[i].label, cw->words[i].w.d);
-  printf("\t\t\t\t</ul>\n");
-  printf("\t\t\t</td>\n");
-  printf("\t\t\t<td>\n");
-  printf("\t\t\t\t<h2>Down</h2>\n");
-  printf("\t\t\t\t<ul>\n");
+    if(HORIZONTAL == cw->words[i].orient) l->across[l->nb_across++] = i;
+  l->down = l->across + l->nb_across;
   for(i = 0; i < cw->nb_words; i++)
-    if(cw->words[i].orient == VERTICAL)
-      printf("\t\t\t\t\t<li>%i - %s</li>\n", cw->words[i].label, cw->words[i].w.d);
-  printf("\t\t\t\t</ul>\n");
-  printf("\t\t\t</td>\n");
-  printf("\t\t</tr>\n");
-  printf("\t</table>\n");
-  printf("</body>\n");
-  printf("</html>\n");
-
+    if(VERTICAL == cw->words[i].orient) l->down[l->nb_down++] = i;
   return 0;
 }
+
+/*
+ * Free the memory of a layout.
+ * l : the layout.
+ */
+void output_layout_free(output_layout* l){
+  free(l->across);
+  l->across = NULL;
+  l->down = NULL;
+}
+
+/*
+ * Render a crossword in a given format.
+ * b      : the buffer (the document is appended).
+ * cw     : the crossword. Must be initialized.
+ * wl     : the list of words the crossword was computed from.
+ * format : the format (see output_backends).
+ * Returns 0 if all went well. -1 otherwise (out of memory).
+ */
+int cw_render_format(buffer* b, crossword cw, word_list wl, int format){
+  output_layout l;
+
+  if((format < 0) || (format >= NB_FORMATS)) format = TEXT_FORMAT;
+  if(0 != output_layout_init(&l, cw, wl)) return -1;
+  output_backends[format].render(b, &l);
+  output_layout_free(&l);
+  return b->error ? -1 : 0;
+}
+
+/*
+ * Print a crossword in a given format.
+ * f      : the file where to print the crossword.
+ * cw     : the crossword. Must be initialized.
+ * wl     : the list of words the crossword was computed from.
+ * format : the format (see output_backends).
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_print_format(FILE *f, crossword cw, word_list wl, int format){
+  buffer b;
+  int res;
+
+  // The whole document is built in memory and written at once.
+  buf_init(&b);
+  res = cw_render_format(&b, cw, wl, format);
+  if((0 == res) && (0 != buf_write(&b, f))) res = -1;
+  buf_free(&b);
+  return res;
+}
+
+/*
+ * Print a crossword.
+ * f  : the file where to print the crossword.
+ * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
+ */
+void cw_print(FILE *f, crossword cw, word_list wl){
+  cw_print_format(f, cw, wl, TEXT_FORMAT);
+}
+
+/*
+ * Print a crossword in LaTeX mode.
+ * f  : the file where to print the crossword.
+ * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_print_latex(FILE *f, crossword cw, word_list wl){
+  return cw_print_format(f, cw, wl, LATEX_FORMAT);
+}
+
+/*
+ * Print a crossword in HTML mode.
+ * f  : the file where to print the crossword.
+ * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_print_html(FILE *f, crossword cw, word_list wl){
+  return cw_print_format(f, cw, wl, HTML_FORMAT);
+}
@@ -4,33 +4,127 @@
  *   Definition of the functions printing a crossword in different formats. *
  *   The most simple way to visualize a crossword is through the command    *
  *   line in mode text, but crosswords can also be printed in the LaTeX and *
- *   HTML formats.
+ *   HTML formats (and in JSON). A crossword is rendered in a buffer (see  *
+ *   buffer.h) that is written at once, or kept in memory by the caller.    *
+ *   Each format is a backend rendering a layout of the crossword computed  *
+ *   once (bounding box and lists of clues).                                *
  * Author: Rodolphe Lepigre <rlepigre@gmail.com>                            *
  ****************************************************************************/
 #ifndef __OUTPUT_H__
 #define __OUTPUT_H__
 
+#include <stdio.h>
 #include "cw.h"
+#include "buffer.h"
+
+/*
+ * Output formats
+ */
+#define TEXT_FORMAT 0
+#define LATEX_FORMAT 1
+#define HTML_FORMAT 2
+#define JSON_FORMAT 3
+#define NB_FORMATS 4
+
+/*
+ * Traversal of a crossword shared by the backends, computed once.
+ */
+typedef struct __output_layout__{
+  crossword cw;          // The crossword.
+  word_list wl;          // The list of words the crossword was computed from.
+  int xmin;              // First column holding a letter.
+  int ymin;              // First line holding a letter.
+  int xmax;              // Last column holding a letter (-1 if none).
+  int ymax;              // Last line holding a letter (-1 if none).
+  int* across;           // Horizontal words (indices in cw->words, in the
+                         // order of placement).
+  int nb_across;         // Number of horizontal words.
+  int* down;             // Vertical words (indices in cw->words).
+  int nb_down;           // Number of vertical words.
+}output_layout;
+
+/*
+ * An output backend. A backend only appends to its buffer, so that several
+ * crosswords can be rendered concurrently.
+ */
+typedef struct __output_backend__{
+  const char* name;      // Name of the format (see output_format).
+  const char* title;     // Name of the format in the messages.
+  const char* ext;       // Extension of the files.
+  void (*render)(buffer* b, output_layout* l); // Appends a crossword to b.
+}output_backend;
+
+/*
+ * The output backends, indexed by format (TEXT_FORMAT...).
+ */
+extern const output_backend output_backends[NB_FORMATS];
+
+/*
+ * Find a format from its name.
+ * name : the name (text, latex, html or json).
+ * Returns the format, -1 if there is none with this name.
+ */
+int output_format(const char* name);
+
+/*
+ * Compute the layout of a crossword.
+ * l  : the layout (result).
+ * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int output_layout_init(output_layout* l, crossword cw, word_list wl);
+
+/*
+ * Free the memory of a layout.
+ * l : the layout.
+ */
+void output_layout_free(output_layout* l);
+
+/*
+ * Render a crossword in a given format.
+ * b      : the buffer (the document is appended).
+ * cw     : the crossword. Must be initialized.
+ * wl     : the list of words the crossword was computed from.
+ * format : the format (see output_backends).
+ * Returns 0 if all went well. -1 otherwise (out of memory).
+ */
+int cw_render_format(buffer* b, crossword cw, word_list wl, int format);
 
 /*
  * Print a crossword.
  * f  : the file where to print the crossword.
  * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
  */
-void cw_print(FILE *f, crossword cw);
+void cw_print(FILE *f, crossword cw, word_list wl);
 
 /*
  * Print a crossword in LaTeX mode.
+ * f  : the file where to print the crossword.
  * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
  * Returns 0 if all went well. -1 otherwise.
  */
-int cw_print_latex(crossword cw);
+int cw_print_latex(FILE *f, crossword cw, word_list wl);
 
 /*
  * Print a crossword in HTML mode.
+ * f  : the file where to print the crossword.
  * cw : the crossword. Must be initialized.
+ * wl : the list of words the crossword was computed from.
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_print_html(FILE *f, crossword cw, word_list wl);
+
+/*
+ * Print a crossword in a given format.
+ * f      : the file where to print the crossword.
+ * cw     : the crossword. Must be initialized.
+ * wl     : the list of words the crossword was computed from.
+ * format : the format (see output_backends).
  * Returns 0 if all went well. -1 otherwise.
  */
-int cw_print_html(crossword cw);
+int cw_print_format(FILE *f, crossword cw, word_list wl, int format);
 
 #endif
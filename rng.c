@@ -0,0 +1,97 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** rng.c *******************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "rng.h".                    *
+ ****************************************************************************/
+#include <stdint.h>
+#include "rng.h"
+
+/*
+ * Rotate a 64 bits number to the left.
+ */
+#define ROTL(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+/*
+ * Initialize a random generator from a seed.
+ * r    : the random generator.
+ * seed : the seed (any value).
+ */
+void rng_seed(rng* r, uint64_t seed){
+  uint64_t z;
+  int i;
+
+  // The state is filled using splitmix64, so that close seeds give
+  // unrelated streams and the state is never all zero.
+  for(i = 0; i < 4; i++){
+    seed += 0x9E3779B97F4A7C15ULL;
+    z = seed;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    r->s[i] = z ^ (z >> 31);
+  }
+}
+
+/*
+ * Derive the seed of a run from the seed of a generation. The first run
+ * uses the seed itself, so any run can be replayed alone from its seed.
+ * seed : the seed of the generation.
+ * i    : the index of the run.
+ * Returns the seed of the run.
+ */
+uint64_t rng_derive(uint64_t seed, int i){
+  uint64_t z;
+
+  if(0 == i) return seed;
+
+  // Close seeds must not share runs (seed + i would).
+  z = seed ^ ((uint64_t) i * 0xD1B54A32D192ED03ULL);
+  z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDULL;
+  z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+  return z ^ (z >> 33);
+}
+
+/*
+ * Draw a random number.
+ * r : the random generator.
+ * Returns a uniformly distributed 64 bits number.
+ */
+uint64_t rng_next(rng* r){
+  uint64_t res = ROTL(r->s[1] * 5, 7) * 9;
+  uint64_t t = r->s[1] << 17;
+
+  r->s[2] ^= r->s[0];
+  r->s[3] ^= r->s[1];
+  r->s[1] ^= r->s[2];
+  r->s[0] ^= r->s[3];
+  r->s[2] ^= t;
+  r->s[3] = ROTL(r->s[3], 45);
+
+  return res;
+}
+
+/*
+ * Draw a random number in a range.
+ * r : the random generator.
+ * n : the size of the range. Must be positive.
+ * Returns a number between 0 and n - 1.
+ */
+int rng_int(rng* r, int n){
+  // Multiply and shift (no division), the bias is negligible for the
+  // small ranges we use.
+  return (int) (((rng_next(r) >> 32) * (uint64_t) n) >> 32);
+}
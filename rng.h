@@ -0,0 +1,66 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** rng.h *******************************************************************
+ * Content of this file:                                                    *
+ *   Definition of a reentrant random generator (xoshiro256**). Each run of *
+ *   the algorithm owns its generator, so that runs are reproducible from   *
+ *   their seed and can be done in parallel.                                *
+ ****************************************************************************/
+#ifndef __RNG_H__
+#define __RNG_H__
+
+#include <stdint.h>
+
+/*
+ * Structure representing the state of a random generator.
+ */
+typedef struct __rng__{
+  uint64_t s[4];         // The state (never all zero).
+}rng;
+
+/*
+ * Initialize a random generator from a seed.
+ * r    : the random generator.
+ * seed : the seed (any value).
+ */
+void rng_seed(rng* r, uint64_t seed);
+
+/*
+ * Derive the seed of a run from the seed of a generation. The first run
+ * uses the seed itself, so any run can be replayed alone from its seed.
+ * seed : the seed of the generation.
+ * i    : the index of the run.
+ * Returns the seed of the run.
+ */
+uint64_t rng_derive(uint64_t seed, int i);
+
+/*
+ * Draw a random number.
+ * r : the random generator.
+ * Returns a uniformly distributed 64 bits number.
+ */
+uint64_t rng_next(rng* r);
+
+/*
+ * Draw a random number in a range.
+ * r : the random generator.
+ * n : the size of the range. Must be positive.
+ * Returns a number between 0 and n - 1.
+ */
+int rng_int(rng* r, int n);
+
+#endif
@@ -0,0 +1,116 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** sample.c ****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "sample.h".                 *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "word.h"
+#include "rng.h"
+#include "sample.h"
+
+/*
+ * Initialize a sampler, if the list is too large for the grid.
+ * ws : the sampler.
+ * wl : the list of words.
+ * w  : the width of the grid.
+ * h  : the height of the grid.
+ * Returns 1 if the sampler is initialized, 0 if the list is small enough
+ * to be used as a whole, -1 on error.
+ */
+int sampler_init(word_sampler* ws, word_list wl, int w, int h){
+  int count[MAX_WORD_SIZE + 1];
+  int max_len = ((w > h) ? w : h) - 1; // See cw_ok_add_word_at_pos.
+  long size = (long) SAMPLE_PER_CELL * w * h;
+  int nb_fit = 0;
+  int i, len;
+
+  if(wl->next_free <= size) return 0;
+
+  // Number of words of each length (the words longer than max_len never
+  // fit in the grid).
+  if(max_len > MAX_WORD_SIZE) max_len = MAX_WORD_SIZE;
+  memset(count, 0, sizeof(count));
+  for(i = 0; i < wl->next_free; i++) count[wl->l[i].len]++;
+  for(len = 1; len <= max_len; len++) nb_fit += count[len];
+  if(nb_fit <= size) return 0;
+
+  // Sort the words by length (counting sort).
+  if(NULL == (ws->by_len = malloc(wl->next_free * sizeof(int)))){
+    fprintf(stderr, "Malloc error in sampler_init !\n");
+    return -1;
+  }
+  ws->start[0] = 0;
+  for(len = 0; len <= MAX_WORD_SIZE; len++)
+    ws->start[len + 1] = ws->start[len] + count[len];
+  for(i = 0; i < wl->next_free; i++)
+    ws->by_len[ws->start[wl->l[i].len] + --count[wl->l[i].len]] = i;
+
+  // The share of each length.
+  ws->size = 0;
+  for(len = 0; len <= MAX_WORD_SIZE; len++){
+    ws->quota[len] = 0;
+    if((len < 1) || (len > max_len)) continue;
+    ws->quota[len] = size * (ws->start[len + 1] - ws->start[len]) / nb_fit;
+    ws->size += ws->quota[len];
+  }
+  ws->nb_words = wl->next_free;
+  return 1;
+}
+
+/*
+ * Free the memory allocated to a sampler.
+ * ws : the sampler (initialized).
+ */
+void sampler_free(word_sampler* ws){
+  free(ws->by_len);
+}
+
+/*
+ * Draw a random subset of the list.
+ * ws     : the sampler (initialized).
+ * rn     : the random generator of the run.
+ * marks  : an array of ws->nb_words zeros (zeros again on return).
+ * subset : the indices of the words drawn (result).
+ * Returns the number of words drawn.
+ */
+int sampler_draw(word_sampler* ws, rng* rn, char* marks, int* subset){
+  int nb = 0;
+  int len, n, j, w;
+  int* words;
+
+  for(len = 1; len <= MAX_WORD_SIZE; len++){
+    if(0 == ws->quota[len]) continue;
+    words = &ws->by_len[ws->start[len]];
+    n = ws->start[len + 1] - ws->start[len];
+
+    // Floyd: for j from n - quota to n - 1, draw a word among the j + 1
+    // first ones, or take the j-th one if the word is already drawn.
+    for(j = n - ws->quota[len]; j < n; j++){
+      w = words[rng_int(rn, j + 1)];
+      if(marks[w]) w = words[j];
+      marks[w] = 1;
+      subset[nb++] = w;
+    }
+  }
+
+  for(j = 0; j < nb; j++) marks[subset[j]] = 0;
+  return nb;
+}
@@ -0,0 +1,76 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** sample.h ****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of a sampler drawing, for each run, a random subset of a    *
+ *   large list of words, so that the cost of a run depends on the size of  *
+ *   the grid rather than on the size of the list.                          *
+ ****************************************************************************/
+#ifndef __SAMPLE_H__
+#define __SAMPLE_H__
+
+#include "const.h"
+#include "word.h"
+#include "rng.h"
+
+/*
+ * Structure representing a sampler. The words are grouped by length, and
+ * each length gets a share of the subset proportional to its number of
+ * words (stratified sampling). The words that do not fit in the grid are
+ * never drawn.
+ */
+typedef struct __word_sampler__{
+  int* by_len;           // Indices of the words, sorted by length.
+  int start[MAX_WORD_SIZE + 2];  // Words of length l are between start[l]
+                                 // (included) and start[l + 1] (excluded).
+  int quota[MAX_WORD_SIZE + 1];  // Number of words of length l drawn.
+  int size;              // Size of a subset (sum of the quotas).
+  int nb_words;          // Number of words in the list.
+}word_sampler;
+
+/*
+ * Initialize a sampler, if the list is too large for the grid: a subset
+ * has at most SAMPLE_PER_CELL words per cell of the grid.
+ * ws : the sampler.
+ * wl : the list of words.
+ * w  : the width of the grid.
+ * h  : the height of the grid.
+ * Returns 1 if the sampler is initialized, 0 if the list is small enough
+ * to be used as a whole (nothing is allocated), -1 on error.
+ */
+int sampler_init(word_sampler* ws, word_list wl, int w, int h);
+
+/*
+ * Free the memory allocated to a sampler.
+ * ws : the sampler (initialized).
+ */
+void sampler_free(word_sampler* ws);
+
+/*
+ * Draw a random subset of the list, in time proportional to its size
+ * (Floyd's algorithm, for each length). The sampler is not modified, so
+ * several threads can draw from it.
+ * ws     : the sampler (initialized).
+ * rn     : the random generator of the run.
+ * marks  : an array of ws->nb_words zeros, used to draw distinct words
+ *          (zeros again when the function returns).
+ * subset : the indices of the words drawn (result, ws->size at most).
+ * Returns the number of words drawn.
+ */
+int sampler_draw(word_sampler* ws, rng* rn, char* marks, int* subset);
+
+#endif
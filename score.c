@@ -0,0 +1,141 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** score.c *****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "score.h".                  *
+ ****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "const.h"
+#include "cw.h"
+#include "score.h"
+
+/*
+ * Default weights (see score.h).
+ * sw : the weights (result).
+ */
+void score_default(score_weights* sw){
+  sw->words = 4096;
+  sw->crossings = 64;
+  sw->density = 0;
+  sw->area = -1;
+}
+
+/*
+ * Read weights from a string (see score.h).
+ * s  : the string.
+ * sw : the weights (result).
+ * Returns 0 if all went well, -1 if the string is malformed.
+ */
+int score_parse(const char* s, score_weights* sw){
+  const char* eq;
+  char* end;
+  long* wp;
+  long n;
+
+  sw->words = 0;
+  sw->crossings = 0;
+  sw->density = 0;
+  sw->area = 0;
+
+  while('\0' != *s){
+    if(NULL == (eq = strchr(s, '='))) return -1;
+    if((5 == eq - s) && (0 == strncmp(s, "words", 5))){
+      wp = &sw->words;
+    }else if((9 == eq - s) && (0 == strncmp(s, "crossings", 9))){
+      wp = &sw->crossings;
+    }else if((7 == eq - s) && (0 == strncmp(s, "density", 7))){
+      wp = &sw->density;
+    }else if((4 == eq - s) && (0 == strncmp(s, "area", 4))){
+      wp = &sw->area;
+    }else{
+      return -1;
+    }
+
+    n = strtol(eq + 1, &end, 10);
+    if((end == eq + 1) || ((',' != *end) && ('\0' != *end))) return -1;
+    *wp = n;
+
+    s = end;
+    if(',' == *s) s++;
+  }
+  return 0;
+}
+
+/*
+ * Upper bound of the score of a crossword with all the words of a list.
+ * wl : the list of words.
+ * w  : the width of the crosswords.
+ * h  : the height of the crosswords.
+ * sw : the weights.
+ * Returns the bound.
+ */
+long score_bound(word_list wl, int w, int h, score_weights* sw){
+  long nb = wl->next_free;
+  long letters = 0;
+  long lmax = 0;
+  long lmin = MAX_WORD_SIZE;
+  long cross_min, cross_max, area_min, area_max, dens_min, dens_max;
+  long bound;
+  int i;
+
+  if(0 == nb) return 0;
+  for(i = 0; i < nb; i++){
+    letters += wl->l[i].len;
+    if(wl->l[i].len > lmax) lmax = wl->l[i].len;
+    if(wl->l[i].len < lmin) lmin = wl->l[i].len;
+  }
+
+  // Each word but the first crosses a word, a crossing is a cell of two
+  // words, and two words cross at most once.
+  cross_min = nb - 1;
+  cross_max = letters / 2;
+  if((nb - 1) * nb / 2 < cross_max) cross_max = (nb - 1) * nb / 2;
+
+  // The bounding box holds the cells, and a word of each orientation if
+  // there are several words.
+  area_max = (long) w * h;
+  area_min = (nb > 1) ? lmax * lmin : lmax;
+  if(letters - cross_max > area_min) area_min = letters - cross_max;
+  dens_min = 1000L * (letters - cross_max) / area_max;
+  dens_max = 1000L * (letters - cross_min) / area_min;
+  if(dens_max > 1000) dens_max = 1000;
+
+  bound = sw->words * nb;
+  bound += sw->crossings * ((sw->crossings > 0) ? cross_max : cross_min);
+  bound += sw->density * ((sw->density > 0) ? dens_max : dens_min);
+  bound += sw->area * ((sw->area > 0) ? area_max : area_min);
+  return bound;
+}
+
+/*
+ * Score of a crossword (higher is better).
+ * cw : the crossword.
+ * sw : the weights.
+ * Returns the score.
+ */
+long cw_score(crossword cw, score_weights* sw){
+  long area = 0;
+  long density = 0;
+
+  if(cw->nb_words > 0){
+    area = (long) (cw->xmax - cw->xmin + 1) * (cw->ymax - cw->ymin + 1);
+    density = 1000L * cw->nb_cells / area;
+  }
+  return sw->words * cw->nb_words + sw->crossings * cw->nb_cross +
+         sw->density * density + sw->area * area;
+}
@@ -0,0 +1,78 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** score.h *****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the score of a crossword, a weighted sum of its number   *
+ *   of words, of crossings, of its density and of the area of its bounding *
+ *   box. These statistics are maintained by cw_add_word, so a score is     *
+ *   computed in constant time.                                             *
+ ****************************************************************************/
+#ifndef __SCORE_H__
+#define __SCORE_H__
+
+#include "const.h"
+#include "cw.h"
+
+/*
+ * Weights of the score of a crossword (see cw_score).
+ */
+typedef struct __score_weights__{
+  long words;            // Weight of a word.
+  long crossings;        // Weight of a crossing.
+  long density;          // Weight of the density, in per mille of the
+                         // bounding box covered by letters.
+  long area;             // Weight of a cell of the bounding box.
+}score_weights;
+
+/*
+ * Default weights: the number of words first, then the crossings and a
+ * small bounding box.
+ * sw : the weights (result).
+ */
+void score_default(score_weights* sw);
+
+/*
+ * Read weights from a string of the form "words=4096,area=-1" (the keys are
+ * words, crossings, density and area, a missing key has weight 0).
+ * s  : the string.
+ * sw : the weights (result).
+ * Returns 0 if all went well, -1 if the string is malformed.
+ */
+int score_parse(const char* s, score_weights* sw);
+
+/*
+ * Upper bound of the score of a crossword with all the words of a list: the
+ * crossings, density and area terms are bounded from the number of words
+ * and their lengths (a crossword is connected, and two words cross at most
+ * once). A crossword reaching it cannot be improved on.
+ * wl : the list of words.
+ * w  : the width of the crosswords.
+ * h  : the height of the crosswords.
+ * sw : the weights.
+ * Returns the bound.
+ */
+long score_bound(word_list wl, int w, int h, score_weights* sw);
+
+/*
+ * Score of a crossword (higher is better).
+ * cw : the crossword.
+ * sw : the weights.
+ * Returns the score.
+ */
+long cw_score(crossword cw, score_weights* sw);
+
+#endif
@@ -0,0 +1,297 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** search.c ****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "search.h".                 *
+ ****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "arena.h"
+#include "timer.h"
+#include "search.h"
+
+/*
+ * Maximal number of words counted or compared for a cell, and maximal number
+ * of occurences of its letter looked at, so that the cost of a node stays
+ * bounded with large lists (a cell crossed by that many words is not
+ * constrained anyway).
+ */
+#define SEARCH_SCAN 64
+#define SEARCH_SAMPLE 1024
+
+/*
+ * State of a search.
+ */
+typedef struct __search_state__{
+  crossword cw;          // The crossword being built.
+  word_list wl;          // The list of words.
+  rng* rn;               // The random generator.
+  int l;                 // Next label.
+  long nodes;            // Number of nodes visited.
+  long budget;           // Maximal number of nodes.
+  long deadline;         // Deadline of the search (see timer.h).
+  placed_word* cand;     // Words tried, SEARCH_BRANCH per depth.
+  int max_depth;         // Maximal number of words in the grid.
+  placed_word* best;     // Words of the best crossword found.
+  int nb_best;           // Number of words of the best crossword.
+  int error;             // Set to 1 on error.
+}search_state;
+
+/*
+ * Tells whether a cell of the grid is open (covered by a single word).
+ */
+#define SEARCH_OPEN(cw, x, y) \
+  ((((cw)->rows[(y) + 1] >> ((x) + 1)) & 1) && \
+   ((((cw)->hblock[(y) + 1] >> ((x) + 1)) & 1) != \
+    (((cw)->vblock[(x) + 1] >> ((y) + 1)) & 1)))
+
+/*
+ * Position of a word crossing an open cell of the grid.
+ * cw  : the crossword.
+ * wl  : the list of words.
+ * i   : the index of the word in wl.
+ * pos : the letter of the word on the cell.
+ * x   : x coordinate of the cell (result: x coordinate of the word).
+ * y   : y coordinate of the cell (result: y coordinate of the word).
+ * or  : orientation of the word (result).
+ * Returns the number of crossings of the word if it can be placed there, 0
+ * otherwise.
+ */
+static int search_pos(crossword cw, word_list wl, int i, int pos,
+                      int* x, int* y, int* or){
+  uint32_t line;
+
+  if((cw->vblock[*x + 1] >> (*y + 1)) & 1){
+    *or = HORIZONTAL;
+    *x -= pos;
+    if(*x < 0) return 0;
+    line = cw->rows[*y + 1] >> (*x + 1);
+  }else{
+    *or = VERTICAL;
+    *y -= pos;
+    if(*y < 0) return 0;
+    line = cw->cols[*x + 1] >> (*y + 1);
+  }
+  if(!cw_ok_add_word_at_pos(cw, wl, i, *x, *y, *or)) return 0;
+  return __builtin_popcount(line & CW_BITS(wl->l[i].len));
+}
+
+/*
+ * Choose the next slot to fill: the open cell crossed by the fewest words
+ * (at random among the ties). The words are found through the letter index.
+ * s : the state of the search.
+ * x : x coordinate of the cell (result).
+ * y : y coordinate of the cell (result).
+ * Returns 1 if a word can cross an open cell, 0 otherwise.
+ */
+static int search_slot(search_state* s, int* x, int* y){
+  crossword cw = s->cw;
+  word_list wl = s->wl;
+  int cx, cy, px, py, or;
+  int i, j, k, nb, start, size, first;
+  int best = 0;
+  int nb_ties = 0;
+  unsigned char ch;
+
+  for(cy = 0; cy < cw->height; cy++)
+    for(cx = 0; cx < cw->width; cx++){
+      if(!SEARCH_OPEN(cw, cx, cy)) continue;
+
+      // Count the words crossing the cell (no more than the best), looking
+      // at the occurences of the letter from a random one.
+      ch = (unsigned char) CW_CELL(cw, cx, cy);
+      start = wl->index_start[ch];
+      size = wl->index_start[ch + 1] - start;
+      first = (size > SEARCH_SAMPLE) ? rng_int(s->rn, size) : 0;
+      nb = 0;
+      for(j = 0; (j < size) && (j < SEARCH_SAMPLE); j++){
+        k = start + (first + j) % size;
+        i = wl->index[k].w;
+        if(cw->used[i]) continue;
+        px = cx;
+        py = cy;
+        if(0 == search_pos(cw, wl, i, wl->index[k].pos, &px, &py, &or))
+          continue;
+        if(((++nb > best) && (0 != best)) || (SEARCH_SCAN == nb)) break;
+      }
+
+      if(0 == nb) continue;
+      if((0 == best) || (nb < best)){
+        best = nb;
+        nb_ties = 1;
+      }else if((nb > best) || (0 != rng_int(s->rn, ++nb_ties))){
+        continue;
+      }
+      *x = cx;
+      *y = cy;
+    }
+
+  return (0 != best);
+}
+
+/*
+ * Collect the (at most) SEARCH_BRANCH best words crossing an open cell: the
+ * ones with the most crossings (the grid stays compact), then at random.
+ * Only the first SEARCH_SCAN words that fit (from a random occurence of the
+ * letter, SEARCH_SAMPLE occurences at most) are compared.
+ * s    : the state of the search.
+ * x    : x coordinate of the cell.
+ * y    : y coordinate of the cell.
+ * cand : the words and their positions, best first (result).
+ * Returns the number of words.
+ */
+static int search_collect(search_state* s, int x, int y, placed_word* cand){
+  crossword cw = s->cw;
+  word_list wl = s->wl;
+  unsigned char ch = (unsigned char) CW_CELL(cw, x, y);
+  int px, py, or;
+  int i, j, k, r, nc;
+  int nb = 0;
+  int nb_fit = 0;
+  int start = wl->index_start[ch];
+  int size = wl->index_start[ch + 1] - start;
+  int first = rng_int(s->rn, size);
+  uint64_t key;
+  uint64_t keys[SEARCH_BRANCH];
+
+  // The occurences of the letter, from a random one.
+  for(j = 0; (j < size) && (j < SEARCH_SAMPLE) && (nb_fit < SEARCH_SCAN);
+      j++){
+    k = start + (first + j) % size;
+    i = wl->index[k].w;
+    if(cw->used[i]) continue;
+    px = x;
+    py = y;
+    if(0 == (nc = search_pos(cw, wl, i, wl->index[k].pos, &px, &py, &or)))
+      continue;
+    nb_fit++;
+
+    // Insertion in the sorted words, if good enough.
+    key = ((uint64_t) nc << 32) | (rng_next(s->rn) >> 32);
+    if((SEARCH_BRANCH == nb) && (key <= keys[nb - 1])) continue;
+    if(nb < SEARCH_BRANCH) nb++;
+    for(r = nb - 1; (r > 0) && (keys[r - 1] < key); r--){
+      keys[r] = keys[r - 1];
+      cand[r] = cand[r - 1];
+    }
+    keys[r] = key;
+    cand[r].w = i;
+    cand[r].posx = px;
+    cand[r].posy = py;
+    cand[r].orient = or;
+  }
+  return nb;
+}
+
+/*
+ * A node of the search: fill the most constrained slot with each of its
+ * best words in turn.
+ * s : the state of the search.
+ * Returns 1 if the search must stop, 0 otherwise.
+ */
+static int search_node(search_state* s){
+  crossword cw = s->cw;
+  placed_word* cand;
+  int x, y, k, nb, mark;
+
+  s->nodes++;
+  if(cw->nb_words > s->nb_best){
+    memcpy(s->best, cw->words, cw->nb_words * sizeof(placed_word));
+    s->nb_best = cw->nb_words;
+  }
+  if((cw->nb_words == s->wl->next_free) || (s->nodes >= s->budget) ||
+     (cw->nb_words >= s->max_depth))
+    return 1;
+  // The clock is read at each node: with a large list and grid, a node
+  // costs milliseconds.
+  if(timer_expired(s->deadline)) return 1;
+
+  if(!search_slot(s, &x, &y)) return 0;
+  cand = &s->cand[cw->nb_words * SEARCH_BRANCH];
+  nb = search_collect(s, x, y, cand);
+  for(k = 0; k < nb; k++){
+    mark = cw_mark(cw);
+    if(0 != cw_add_word(cw, s->wl, cand[k].w, cand[k].posx, cand[k].posy,
+                        cand[k].orient, &s->l)){
+      s->error = 1;
+      return 1;
+    }
+    if(search_node(s)) return 1;
+    cw_rollback(cw, mark, &s->l);
+  }
+  return 0;
+}
+
+/*
+ * Compute a crossword by a depth first search, starting from a random word.
+ * cw       : the crossword. Must be initialized and empty (see cw_reset).
+ * wl       : the list of words.
+ * rn       : the random generator of the run.
+ * scratch  : arena for the state of the search (reset by the caller).
+ * budget   : maximal number of nodes.
+ * deadline : deadline of the search , TIMER_NONE if none (see timer.h).
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_search(crossword cw, word_list wl, rng* rn, arena* scratch,
+              long budget, long deadline){
+  search_state s;
+  int nw = wl->next_free;
+  int k, res;
+
+  // No words to place.
+  if(0 == nw) return 0;
+
+  // A word starts at a cell, and there are two orientations.
+  s.cw = cw;
+  s.wl = wl;
+  s.rn = rn;
+  s.l = 1;
+  s.nodes = 0;
+  s.budget = budget;
+  s.deadline = deadline;
+  s.max_depth = 2 * cw->width * cw->height;
+  if(s.max_depth > nw) s.max_depth = nw;
+  s.nb_best = 0;
+  s.error = 0;
+  s.cand = arena_alloc(scratch,
+                       s.max_depth * SEARCH_BRANCH * sizeof(placed_word));
+  s.best = arena_alloc(scratch, s.max_depth * sizeof(placed_word));
+  if((NULL == s.cand) || (NULL == s.best)){
+    fprintf(stderr, "Memory allocation error in cw_search !\n");
+    return -1;
+  }
+
+  // Search from a random first word (words are removed with the journal).
+  if(0 != cw_journal_init(cw)) return -1;
+  if(1 != (res = cw_add_first_word(cw, wl, &s.l, rn)))
+    return res;
+  search_node(&s);
+  if(s.error) return -1;
+
+  // Rebuild the best crossword.
+  cw_reset(cw);
+  s.l = 1;
+  for(k = 0; k < s.nb_best; k++)
+    if(0 != cw_add_word(cw, wl, s.best[k].w, s.best[k].posx, s.best[k].posy,
+                        s.best[k].orient, &s.l))
+      return -1;
+  return 0;
+}
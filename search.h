@@ -0,0 +1,52 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** search.h ****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the search engine: a depth first search that fills the   *
+ *   most constrained slot first (the open cell crossed by the fewest       *
+ *   words), and backtracks by removing words from the grid. An alternative *
+ *   to the random algorithm of "cw.h".                                     *
+ ****************************************************************************/
+#ifndef __SEARCH_H__
+#define __SEARCH_H__
+
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "arena.h"
+
+/*
+ * Compute a crossword by a depth first search, starting from a random word.
+ * At each node the open cell (crossed by a single word) that can be crossed
+ * by the fewest words is chosen (words found through the letter index), and
+ * at most SEARCH_BRANCH of these words are tried, the ones with the most
+ * crossings first. The search stops when all the words are placed or after
+ * budget nodes (or at the deadline), and the crossword with the most words
+ * is kept.
+ * cw       : the crossword. Must be initialized and empty (see cw_reset).
+ * wl       : the list of words.
+ * rn       : the random generator of the run.
+ * scratch  : arena for the state of the search (reset by the caller).
+ * budget   : maximal number of nodes.
+ * deadline : deadline of the search, TIMER_NONE if none (see timer.h).
+ * Returns 0 if all went well. -1 otherwise.
+ */
+int cw_search(crossword cw, word_list wl, rng* rn, arena* scratch,
+              long budget, long deadline);
+
+#endif
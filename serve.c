@@ -0,0 +1,440 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** serve.c *****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "serve.h".                  *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "const.h"
+#include "word.h"
+#include "cw.h"
+#include "rng.h"
+#include "gen.h"
+#include "score.h"
+#include "timer.h"
+#include "buffer.h"
+#include "output.h"
+#include "serve.h"
+
+/*
+ * Maximal length of a request.
+ */
+#define SERVE_LINE 1024
+
+/*
+ * A request.
+ */
+typedef struct __serve_request__{
+  int list;              // Index of the list of words.
+  int format;            // Output format (see output.h).
+  gen_params gen;        // Parameters of the generation.
+}serve_request;
+
+/*
+ * State shared by the workers of a server.
+ */
+typedef struct __serve_shared__{
+  pthread_mutex_t lock;  // Protects all the fields below.
+  pthread_cond_t ready;  // Signaled when a connection is queued.
+  serve_params* p;       // The parameters.
+  int* fds;              // Queued connections (circular buffer).
+  int size;              // Size of the buffer (queue and workers).
+  int head;              // First queued connection.
+  int nb;                // Number of queued connections.
+  int idle;              // Number of workers waiting for a connection.
+  int stop;              // Set to 1 when the workers must end.
+  int count;             // Number of requests received.
+}serve_shared;
+
+/*
+ * Read a number of a request.
+ * v   : the value.
+ * min : the minimal value.
+ * max : the maximal value.
+ * n   : the number (result).
+ * Returns 0 if all went well, -1 otherwise.
+ */
+static int serve_number(const char* v, long long min, long long max,
+                        long long* n){
+  char* end;
+
+  *n = strtoll(v, &end, 10);
+  if(('\0' == *v) || ('\0' != *end) || (*n < min) || (*n > max)) return -1;
+  return 0;
+}
+
+/*
+ * Read a seed of a request (any 64 bits integer, as on the command line).
+ * v : the value.
+ * n : the seed (result).
+ * Returns 0 if all went well, -1 otherwise.
+ */
+static int serve_seed(const char* v, uint64_t* n){
+  unsigned long long u;
+  char* end;
+
+  errno = 0;
+  u = strtoull(v, &end, 10);
+  if(('\0' == *v) || ('-' == *v) || ('\0' != *end) || (ERANGE == errno))
+    return -1;
+  *n = (uint64_t) u;
+  return 0;
+}
+
+/*
+ * Read a request.
+ * s    : the shared state.
+ * line : the request (modified).
+ * r    : the request (result).
+ * Returns NULL if all went well, an error message otherwise.
+ */
+static const char* serve_parse(serve_shared* s, char* line,
+                               serve_request* r){
+  char* save = NULL;
+  char* key;
+  char* v;
+  long long n;
+  int seeded = 0;
+  int timed = 0;
+
+  // Default request.
+  r->list = 0;
+  r->format = TEXT_FORMAT;
+  r->gen.width = DEFAULT_WIDTH;
+  r->gen.height = DEFAULT_HEIGHT;
+  r->gen.tries = 0;
+  // On a socket the connections are served in parallel, on the standard
+  // input the runs of a crossword are.
+  r->gen.nb_threads = (NULL == s->p->path) ? s->p->nb_threads : 1;
+  r->gen.algo = ALGO_RANDOM;
+  r->gen.nodes = SEARCH_NODES;
+  r->gen.anneal_ms = ANNEAL_MS;
+  r->gen.time_ms = SERVE_MS;
+  score_default(&r->gen.weights);
+  r->gen.seed = 0;
+  r->gen.verbose = 0;
+
+  for(key = strtok_r(line, " \t\r\n", &save); NULL != key;
+      key = strtok_r(NULL, " \t\r\n", &save)){
+    if(NULL == (v = strchr(key, '='))) return "field without value";
+    *v++ = '\0';
+    if(0 == strcmp(key, "list")){
+      if(0 != serve_number(v, 0, s->p->nb_lists - 1, &n))
+        return "no such list";
+      r->list = (int) n;
+    }else if(0 == strcmp(key, "width")){
+      if(0 != serve_number(v, MIN_SIZE, MAX_SIZE, &n)) return "bad width";
+      r->gen.width = (int) n;
+    }else if(0 == strcmp(key, "height")){
+      if(0 != serve_number(v, MIN_SIZE, MAX_SIZE, &n)) return "bad height";
+      r->gen.height = (int) n;
+    }else if(0 == strcmp(key, "format")){
+      if(-1 == (r->format = output_format(v))) return "bad format";
+    }else if(0 == strcmp(key, "seed")){
+      if(0 != serve_seed(v, &r->gen.seed)) return "bad seed";
+      seeded = 1;
+    }else if(0 == strcmp(key, "time")){
+      if(0 != serve_number(v, 1, SERVE_MS, &n)) return "bad time";
+      r->gen.time_ms = (long) n;
+      timed = 1;
+    }else if(0 == strcmp(key, "tries")){
+      if(0 != serve_number(v, 1, INT_MAX, &n)) return "bad tries";
+      r->gen.tries = (int) n;
+    }else if(0 == strcmp(key, "algo")){
+      if(0 == strcmp(v, "random")) r->gen.algo = ALGO_RANDOM;
+      else if(0 == strcmp(v, "search")) r->gen.algo = ALGO_SEARCH;
+      else if(0 == strcmp(v, "anneal")) r->gen.algo = ALGO_ANNEAL;
+      else return "bad algo";
+    }else{
+      return "unknown field";
+    }
+  }
+
+  // As on the command line (see main.c), but a request never takes more
+  // than SERVE_MS.
+  if(0 == r->gen.tries) r->gen.tries = timed ? INT_MAX : NB_RUN;
+  pthread_mutex_lock(&s->lock);
+  n = s->count++;
+  pthread_mutex_unlock(&s->lock);
+  if(!seeded) r->gen.seed = rng_derive((uint64_t) time(NULL), (int) n);
+  return NULL;
+}
+
+/*
+ * Answer a request.
+ * s    : the shared state.
+ * line : the request (modified).
+ * out  : where to write the answer.
+ */
+static void serve_answer(serve_shared* s, char* line, FILE* out){
+  serve_request r;
+  word_list wl;
+  crossword cw = NULL;
+  const char* err;
+  buffer buf;
+  long start = timer_now();
+
+  if(NULL != (err = serve_parse(s, line, &r))){
+    fprintf(out, "ERR %s\n", err);
+    return;
+  }
+  wl = s->p->lists[r.list];
+  if(0 != cw_generate(&cw, wl, &r.gen)){
+    fprintf(out, "ERR generation failed\n");
+    return;
+  }
+
+  // The crossword is rendered in memory, so that its size is known.
+  buf_init(&buf);
+  if(0 != cw_render_format(&buf, cw, wl, r.format)){
+    fprintf(out, "ERR out of memory\n");
+  }else{
+    fprintf(out, "OK %lu %llu\n", (unsigned long) buf.len,
+                 (unsigned long long) r.gen.seed);
+    buf_write(&buf, out);
+  }
+  if(s->p->verbose)
+    fprintf(stderr, "Request %dx%d (seed %llu): %d/%d words, %ld ms.\n",
+                    r.gen.width, r.gen.height,
+                    (unsigned long long) r.gen.seed, cw->nb_words,
+                    wl->next_free, timer_now() - start);
+  buf_free(&buf);
+  cw_free(cw);
+}
+
+/*
+ * Serve the requests of a connection, until its end.
+ * s   : the shared state.
+ * in  : where to read the requests.
+ * out : where to write the answers.
+ */
+static void serve_connection(serve_shared* s, FILE* in, FILE* out){
+  char line[SERVE_LINE];
+  int c;
+
+  while(NULL != fgets(line, SERVE_LINE, in)){
+    if((NULL == strchr(line, '\n')) && !feof(in)){
+      // Skip the end of a request that is too long.
+      while((EOF != (c = fgetc(in))) && ('\n' != c));
+      fprintf(out, "ERR request too long\n");
+    }else if(strspn(line, " \t\r\n") != strlen(line)){
+      serve_answer(s, line, out);
+    }
+    if(0 != fflush(out)) break; // Connection closed.
+  }
+}
+
+/*
+ * Worker: serves the queued connections, one at a time, until the server
+ * stops.
+ * arg : the shared state (serve_shared*).
+ * Returns NULL.
+ */
+static void* serve_worker(void* arg){
+  serve_shared* s = (serve_shared*) arg;
+  FILE* in;
+  FILE* out;
+  int fd, fd2;
+
+  while(1){
+    pthread_mutex_lock(&s->lock);
+    s->idle++;
+    while((0 == s->nb) && !s->stop) pthread_cond_wait(&s->ready, &s->lock);
+    s->idle--;
+    if(s->stop){
+      pthread_mutex_unlock(&s->lock);
+      break;
+    }
+    fd = s->fds[s->head];
+    s->head = (s->head + 1) % s->size;
+    s->nb--;
+    pthread_mutex_unlock(&s->lock);
+
+    in = fdopen(fd, "r");
+    out = ((NULL == in) || (-1 == (fd2 = dup(fd)))) ? NULL : fdopen(fd2, "w");
+    if(NULL == out){
+      fprintf(stderr, "Cannot open a connection in serve_worker !\n");
+      if(NULL != in) fclose(in);
+      else close(fd);
+      continue;
+    }
+    serve_connection(s, in, out);
+    fclose(out);
+    fclose(in);
+  }
+  return NULL;
+}
+
+/*
+ * Stop the workers of a server (they end their connection first), and
+ * close the connections still queued.
+ * s  : the shared state.
+ * th : the workers.
+ * nb : the number of workers.
+ */
+static void serve_stop(serve_shared* s, pthread_t* th, int nb){
+  int i;
+
+  pthread_mutex_lock(&s->lock);
+  s->stop = 1;
+  pthread_cond_broadcast(&s->ready);
+  pthread_mutex_unlock(&s->lock);
+  for(i = 0; i < nb; i++) pthread_join(th[i], NULL);
+  for(; s->nb > 0; s->nb--){
+    close(s->fds[s->head]);
+    s->head = (s->head + 1) % s->size;
+  }
+}
+
+/*
+ * Accept connections on a Unix domain socket and queue them.
+ * s : the shared state.
+ * Returns -1 on error (never returns otherwise).
+ */
+static int serve_socket(serve_shared* s){
+  struct sockaddr_un addr;
+  struct stat st;
+  struct timeval idle;
+  pthread_t* th;
+  int sock, fd, i;
+  const char* busy = "ERR busy\n";
+
+  if(strlen(s->p->path) >= sizeof(addr.sun_path)){
+    fprintf(stderr, "The path of the socket is too long...\n");
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, s->p->path);
+
+  // A socket left by a previous server is replaced.
+  if((0 == stat(s->p->path, &st)) && S_ISSOCK(st.st_mode))
+    unlink(s->p->path);
+  if((-1 == (sock = socket(AF_UNIX, SOCK_STREAM, 0))) ||
+     (0 != bind(sock, (struct sockaddr*) &addr, sizeof(addr))) ||
+     (0 != listen(sock, s->p->queue))){
+    fprintf(stderr, "Cannot listen on %s...\n", s->p->path);
+    if(-1 != sock) close(sock);
+    return -1;
+  }
+
+  // The workers are joined when the server stops on an error.
+  if(NULL == (th = malloc(s->p->nb_threads * sizeof(pthread_t)))){
+    fprintf(stderr, "Malloc error in cw_serve !\n");
+    close(sock);
+    return -1;
+  }
+  for(i = 0; i < s->p->nb_threads; i++){
+    if(0 != pthread_create(&th[i], NULL, serve_worker, s)){
+      fprintf(stderr, "Thread creation error in cw_serve !\n");
+      serve_stop(s, th, i);
+      free(th);
+      close(sock);
+      return -1;
+    }
+  }
+  if(s->p->verbose)
+    fprintf(stderr, "Listening on %s (%d workers).\n", s->p->path,
+                    s->p->nb_threads);
+
+  while(1){
+    if(-1 == (fd = accept(sock, NULL, NULL))){
+      if(EINTR == errno) continue;
+      fprintf(stderr, "Error while accepting a connection !\n");
+      serve_stop(s, th, s->p->nb_threads);
+      free(th);
+      close(sock);
+      return -1;
+    }
+
+    // An idle client (not sending requests, or not reading the answers)
+    // does not hold a worker for more than SERVE_IDLE seconds.
+    idle.tv_sec = SERVE_IDLE;
+    idle.tv_usec = 0;
+    if((0 != setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle))) ||
+       (0 != setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &idle, sizeof(idle))))
+      fprintf(stderr, "Cannot set the timeout of a connection !\n");
+
+    // The connection is refused if the queue is full (the connections taken
+    // by idle workers do not wait).
+    pthread_mutex_lock(&s->lock);
+    if(s->nb >= s->idle + s->p->queue){
+      pthread_mutex_unlock(&s->lock);
+      if(write(fd, busy, strlen(busy)) < 0)
+        fprintf(stderr, "Cannot refuse a connection !\n");
+      close(fd);
+      continue;
+    }
+    s->fds[(s->head + s->nb) % s->size] = fd;
+    s->nb++;
+    pthread_cond_signal(&s->ready);
+    pthread_mutex_unlock(&s->lock);
+  }
+  return -1;
+}
+
+/*
+ * Serve requests.
+ * p : the parameters of the server.
+ * Returns 0 if all went well (end of the input), -1 otherwise.
+ */
+int cw_serve(serve_params* p){
+  serve_shared s;
+  int res = 0;
+
+  // A client closing its connection must not stop the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  s.p = p;
+  s.size = p->queue + p->nb_threads;
+  s.head = 0;
+  s.nb = 0;
+  s.idle = 0;
+  s.stop = 0;
+  s.count = 0;
+  if(NULL == (s.fds = malloc(s.size * sizeof(int)))){
+    fprintf(stderr, "Malloc error in cw_serve !\n");
+    return -1;
+  }
+  if((0 != pthread_mutex_init(&s.lock, NULL)) ||
+     (0 != pthread_cond_init(&s.ready, NULL))){
+    fprintf(stderr, "Mutex initialization error in cw_serve !\n");
+    free(s.fds);
+    return -1;
+  }
+
+  if(NULL == p->path) serve_connection(&s, stdin, stdout);
+  else res = serve_socket(&s);
+
+  pthread_cond_destroy(&s.ready);
+  pthread_mutex_destroy(&s.lock);
+  free(s.fds);
+  return res;
+}
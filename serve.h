@@ -0,0 +1,70 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** serve.h *****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of the server mode: lists of words are loaded once, and     *
+ *   crosswords are generated on request (line protocol on a Unix domain    *
+ *   socket or on the standard input and output).                           *
+ ****************************************************************************/
+#ifndef __SERVE_H__
+#define __SERVE_H__
+
+#include "const.h"
+#include "word.h"
+
+/*
+ * Protocol. A request is a line of space separated fields key=value:
+ *   list=int     : index of the list of words (0 by default).
+ *   width=int    : width of the crossword.
+ *   height=int   : height of the crossword.
+ *   format=name  : text (default), latex, html or json.
+ *   seed=int     : seed of the generation (drawn by the server if none).
+ *   time=int     : time limit, in milliseconds (SERVE_MS at most, and by
+ *                  default).
+ *   tries=int    : number of runs.
+ *   algo=name    : random (default), search or anneal.
+ * The answer is either a line "OK size seed" followed by the size bytes of
+ * the crossword, or a line "ERR message". An empty line is ignored. A
+ * connection is closed after SERVE_IDLE seconds without a request.
+ */
+
+/*
+ * Parameters of a server.
+ */
+typedef struct __serve_params__{
+  word_list* lists;      // The lists of words.
+  int nb_lists;          // Number of lists.
+  const char* path;      // Path of the socket, NULL for the standard input
+                         // and output.
+  int nb_threads;        // Number of worker threads.
+  int queue;             // Maximal number of connections waiting for a
+                         // worker (the others are refused).
+  int verbose;           // If set to 1 verbose mode. 0 otherwise.
+}serve_params;
+
+/*
+ * Serve requests. On a socket, the connections are put in a queue and each
+ * of them is served by a worker of a pool, request after request (each
+ * crossword is then generated on a single thread). On the standard input,
+ * the requests are served in order until the end of the input, and the
+ * runs of each crossword are spread over the threads.
+ * p : the parameters of the server.
+ * Returns 0 if all went well (end of the input), -1 otherwise.
+ */
+int cw_serve(serve_params* p);
+
+#endif
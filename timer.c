@@ -0,0 +1,54 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** timer.c *****************************************************************
+ * Content of this file:                                                    *
+ *   Implementation of the functions defined in "timer.h".                  *
+ ****************************************************************************/
+#include <time.h>
+#include "timer.h"
+
+/*
+ * Current time, in milliseconds (monotonic clock).
+ * Returns the current time.
+ */
+long timer_now(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  // Shifted by one so that the current time is never TIMER_NONE.
+  return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L + 1;
+}
+
+/*
+ * Compute a deadline.
+ * ms : a delay, in milliseconds. No deadline if not positive.
+ * Returns the deadline, TIMER_NONE if there is none.
+ */
+long timer_deadline(long ms){
+  if(ms <= 0) return TIMER_NONE;
+  return timer_now() + ms;
+}
+
+/*
+ * Check if a deadline has passed (reads the clock).
+ * deadline : the deadline (see timer_deadline).
+ * Returns 1 if the deadline has passed, 0 otherwise (or if there is none).
+ */
+int timer_expired(long deadline){
+  if(TIMER_NONE == deadline) return 0;
+  return timer_now() >= deadline;
+}
@@ -0,0 +1,51 @@
+/** Copyright (c) 2012-2013 Rodolphe Lepigre ********************************
+ * This file is part of CWG.                                                *
+ *                                                                          *
+ * CWG is free software: you can redistribute it and/or modify it under the *
+ * terms of the GNU General Public License as published by the Free Softwa- *
+ * re Foundation, either version 3 of the License, or (at your option) any  *
+ * later version.                                                           *
+ *                                                                          *
+ * This program is distributed in the hope that it will be useful, but      *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABI-  *
+ * LITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public Li- *
+ * cense for more details.                                                  *
+ *                                                                          *
+ * You should have received a copy of the GNU General Public License along  *
+ * with this program. If not, see <http://www.gnu.org/licenses/>.           *
+ *                                                                          *
+ ** timer.h *****************************************************************
+ * Content of this file:                                                    *
+ *   Definition of a monotonic clock in milliseconds, used for the time     *
+ *   budgets and the deadlines of the generation.                           *
+ ****************************************************************************/
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+/*
+ * Value of a deadline meaning "no deadline".
+ */
+#define TIMER_NONE 0
+
+/*
+ * Current time, in milliseconds (monotonic clock, arbitrary origin but
+ * always positive).
+ * Returns the current time.
+ */
+long timer_now(void);
+
+/*
+ * Compute a deadline.
+ * ms : a delay, in milliseconds. No deadline if not positive.
+ * Returns the deadline, TIMER_NONE if there is none.
+ */
+long timer_deadline(long ms);
+
+/*
+ * Check if a deadline has passed (reads the clock).
+ * deadline : the deadline (see timer_deadline).
+ * Returns 1 if the deadline has passed, 0 otherwise (or if there is none).
+ */
+int timer_expired(long deadline);
+
+#endif
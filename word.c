@@ -23,34 +23,322 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
 #include "const.h"
 #include "word.h"
+#include "dict.h"
 
 /*
- * Function scanning a file for words.
+ * Read a whole file in an allocated buffer (when it cannot be mapped).
  * input : the file.
- * list  : the list of words scanned.
- * verbose : if set to 1 verbose mode. 0 otherwise.
+ * size  : the size of the text (result).
+ * Returns the text, NULL on failure.
+ */
+static char* read_all(FILE* input, size_t* size){
+  char* text = NULL;
+  char* tmp;
+  size_t cap = 0;
+  size_t nb;
+
+  *size = 0;
+  do{
+    if(*size == cap){
+      cap = (0 == cap) ? 4096 : 2 * cap;
+      if(NULL == (tmp = realloc(text, cap))){
+        free(text);
+        return NULL;
+      }
+      text = tmp;
+    }
+    nb = fread(text + *size, 1, cap - *size, input);
+    *size += nb;
+  }while(0 != nb);
+
+  if(ferror(input)){
+    free(text);
+    return NULL;
+  }
+  return text;
+}
+
+/*
+ * Minimal size of the text parsed by each thread.
+ */
+#define SCAN_CHUNK (1 << 18)
+
+/*
+ * A chunk of the text of a list, parsed (by one thread) in its own buffers.
+ */
+typedef struct __scan_chunk__{
+  char* text;            // Text of the list (the clue offsets are global).
+  char* start;           // First line of the chunk.
+  char* end;             // End of the chunk (just after a '\n', or the end
+                         // of the text).
+  int lenient;           // 1 to skip malformed lines, 0 to stop on them.
+  arena mem;             // Memory of the chunk (words and diagnostics).
+  word* l;               // Words of the chunk.
+  int nb;                // Number of words.
+  scan_diag* diags;      // Diagnostics, the lines are counted from the start
+                         // of the chunk.
+  int nb_diags;          // Number of diagnostics.
+  int size_diags;        // Capacity of diags.
+  int nb_lines;          // Number of lines consumed.
+  int stop;              // 1 if the list ends in the chunk (empty line, or
+                         // error when not lenient).
+  int error;             // 1 if a memory allocation failed.
+  pthread_t th;          // Thread parsing the chunk.
+  int threaded;          // 1 if the chunk is parsed by th.
+}scan_chunk;
+
+/*
+ * Print a diagnostic.
+ * out  : the output.
+ * kind : kind of message ("Parsing error" for instance).
+ * d    : the diagnostic.
+ */
+static void fprint_diag(FILE* out, const char* kind, scan_diag* d){
+  fprintf(out, "%s, at line %i... (%s)\n", kind, d->line, d->msg);
+  if(0 != d->max)
+    fprintf(out, "Size must be between %i and %i.\n", d->min, d->max);
+}
+
+/*
+ * Add a diagnostic to a chunk.
+ * c    : the chunk.
+ * msg  : the reason.
+ * min  : minimal size of the faulty element (if max is not 0).
+ * max  : maximal size of the faulty element, 0 if not a size error.
+ * Returns 0 if all went well, -1 otherwise.
+ */
+static int scan_diag_add(scan_chunk* c, const char* msg, int min, int max){
+  scan_diag* tmp;
+
+  if(c->nb_diags == c->size_diags){
+    c->size_diags = (0 == c->size_diags) ? INIT_NB : 2 * c->size_diags;
+    tmp = arena_alloc(&c->mem, c->size_diags * sizeof(scan_diag));
+    if(NULL == tmp) return -1;
+    if(0 != c->nb_diags) memcpy(tmp, c->diags, c->nb_diags * sizeof(scan_diag));
+    c->diags = tmp;
+  }
+  c->diags[c->nb_diags].line = c->nb_lines;
+  c->diags[c->nb_diags].msg = msg;
+  c->diags[c->nb_diags].min = min;
+  c->diags[c->nb_diags].max = max;
+  c->nb_diags++;
+  return 0;
+}
+
+/*
+ * Parse the lines of a chunk, up to the end of the chunk or the first empty
+ * line (thread function).
+ * arg : the chunk (scan_chunk*).
+ * Returns NULL.
+ */
+static void* scan_chunk_words(void* arg){
+  scan_chunk* c = (scan_chunk*) arg;
+  char* p;               // Current line.
+  char* eol;             // End of the current line.
+  char* q;
+  char* wrd;
+  const char* msg;
+  size_t len, dlen, nb_lines;
+  int min, max;
+  word* cur;
+
+  // Size the buffer in one pass (at most one word per line).
+  nb_lines = 1;
+  for(p = c->start; NULL != (p = memchr(p, '\n', c->end - p)); p++)
+    nb_lines++;
+  if(NULL == (c->l = arena_alloc(&c->mem, nb_lines * sizeof(word)))){
+    c->error = 1;
+    return NULL;
+  }
+
+  // Looping through the lines.
+  for(p = c->start; p < c->end; p = eol + 1){
+    if(NULL == (eol = memchr(p, '\n', c->end - p))) eol = c->end;
+    if(eol == p){
+      c->stop = 1;
+      break;
+    }
+    c->nb_lines++;
+
+    // Parsing into word and clue: "WORD : clue".
+    msg = NULL;
+    min = max = 0;
+    for(q = p; (q < eol) && isspace((unsigned char) *q); q++);
+    for(wrd = q; (q < eol) && !isspace((unsigned char) *q); q++);
+    len = q - wrd;
+    for( ; (q < eol) && isspace((unsigned char) *q); q++);
+    if((0 == len) || (q == eol) || (':' != *q)){
+      msg = "no parse";
+    }else{
+      for(q++; (q < eol) && isspace((unsigned char) *q); q++);
+      dlen = eol - q;
+
+      // Checking sizes.
+      if(0 == dlen){
+        msg = "no parse";
+      }else if(len < MIN_WORD_SIZE || len > MAX_WORD_SIZE){
+        msg = "wrong word size";
+        min = MIN_WORD_SIZE;
+        max = MAX_WORD_SIZE;
+      }else if(dlen < MIN_DEF_SIZE){
+        msg = "clue too short";
+      }
+    }
+    if(NULL != msg){
+      if(0 != scan_diag_add(c, msg, min, max)){
+        c->error = 1;
+        break;
+      }
+      if(c->lenient) continue;
+      c->stop = 1;
+      break;
+    }
+
+    // Do the write and update, the clue stays in the text.
+    cur = &c->l[c->nb++];
+    memset(cur->w, '\0', WORD_STORAGE);
+    memcpy(cur->w, wrd, len);
+    cur->d = q - c->text;
+    cur->dlen = dlen;
+    word_info(cur);
+  }
+
+  return NULL;
+}
+
+/*
+ * Parse the text of a list of words, in parallel. The text is split at line
+ * boundaries in chunks parsed by different threads, and the results are
+ * then merged in order.
+ * wl         : the list (its text must be set).
+ * nb_threads : maximal number of threads.
+ * lenient    : 1 to skip malformed lines, 0 to stop on the first one.
+ * verbose    : if set to 1 verbose mode. 0 otherwise.
+ * Returns 0 if all went well, -1 on error (reported on stderr).
+ */
+static int scan_text(word_list wl, int nb_threads, int lenient, int verbose){
+  scan_chunk* chunks;
+  char* end = wl->text + wl->text_size;
+  char* p;
+  char* q;
+  int nb_chunks, nb_used, nb, nb_diags, lines;
+  int k, i, res = 0;
+
+  // Split the text (each chunk ends just after a '\n').
+  nb_chunks = wl->text_size / SCAN_CHUNK;
+  if(nb_chunks > nb_threads) nb_chunks = nb_threads;
+  if(nb_chunks < 1) nb_chunks = 1;
+  if(NULL == (chunks = calloc(nb_chunks, sizeof(scan_chunk)))){
+    fprintf(stderr, "Memory allocation error in fscan_words...\n");
+    return -1;
+  }
+  p = wl->text;
+  for(k = 0; k < nb_chunks; k++){
+    arena_init(&chunks[k].mem, 0);
+    chunks[k].text = wl->text;
+    chunks[k].start = p;
+    chunks[k].lenient = lenient;
+    if(k < nb_chunks - 1){
+      q = wl->text + wl->text_size / nb_chunks * (k + 1);
+      if(p < q) p = q;
+      if(NULL == (p = memchr(p, '\n', end - p))) p = end;
+      else p++;
+    }else{
+      p = end;
+    }
+    chunks[k].end = p;
+  }
+
+  // Parse the chunks, the first one in the calling thread. A chunk whose
+  // thread cannot be created is parsed by the calling thread.
+  for(k = 1; k < nb_chunks; k++)
+    chunks[k].threaded =
+      (0 == pthread_create(&chunks[k].th, NULL, scan_chunk_words, &chunks[k]));
+  for(k = 0; k < nb_chunks; k++)
+    if(!chunks[k].threaded) scan_chunk_words(&chunks[k]);
+  for(k = 1; k < nb_chunks; k++)
+    if(chunks[k].threaded) pthread_join(chunks[k].th, NULL);
+
+  // Count the results, up to the chunk ending the list.
+  nb = nb_diags = lines = 0;
+  for(nb_used = 0; nb_used < nb_chunks; nb_used++){
+    for(i = 0; i < chunks[nb_used].nb_diags; i++)
+      chunks[nb_used].diags[i].line += lines;
+    lines += chunks[nb_used].nb_lines;
+    nb += chunks[nb_used].nb;
+    nb_diags += chunks[nb_used].nb_diags;
+    if(chunks[nb_used].error){
+      fprintf(stderr, "Memory allocation error in fscan_words...\n");
+      res = -1;
+    }
+    if(chunks[nb_used].stop){
+      nb_used++;
+      break;
+    }
+  }
+  if((0 == res) && !lenient && (0 != nb_diags)){
+    fprint_diag(stderr, "Parsing error", chunks[nb_used - 1].diags);
+    res = -1;
+  }
+
+  // Merge the words and the diagnostics (the memory of a single chunk is
+  // used as it is).
+  if((0 == res) && (1 == nb_used)){
+    arena_free(&wl->mem);
+    wl->mem = chunks[0].mem;
+    wl->l = chunks[0].l;
+    wl->diags = chunks[0].diags;
+    arena_init(&chunks[0].mem, 0);
+  }else if(0 == res){
+    wl->l = arena_alloc(&wl->mem, nb * sizeof(word));
+    wl->diags = arena_alloc(&wl->mem, nb_diags * sizeof(scan_diag));
+    if((NULL == wl->l) || (NULL == wl->diags)){
+      fprintf(stderr, "Memory allocation error in fscan_words...\n");
+      res = -1;
+    }
+    nb = nb_diags = 0;
+    for(k = 0; (0 == res) && (k < nb_used); k++){
+      memcpy(wl->l + nb, chunks[k].l, chunks[k].nb * sizeof(word));
+      // A chunk without diagnostics has no array of them.
+      if(chunks[k].nb_diags > 0)
+        memcpy(wl->diags + nb_diags, chunks[k].diags,
+               chunks[k].nb_diags * sizeof(scan_diag));
+      nb += chunks[k].nb;
+      nb_diags += chunks[k].nb_diags;
+    }
+  }
+  wl->next_free = nb;
+  wl->size = nb;
+  wl->nb_diags = nb_diags;
+  if(verbose && (0 == res))
+    fprintf(stderr, "%d lines parsed (%d chunks), %d words, %d skipped.\n",
+                    lines, nb_chunks, nb, nb_diags);
+
+  for(k = 0; k < nb_chunks; k++) arena_free(&chunks[k].mem);
+  free(chunks);
+  return res;
+}
+
+/*
+ * Function scanning a file for words.
+ * input      : the file.
+ * list       : the list of words scanned.
+ * nb_threads : maximal number of threads for the parsing.
+ * lenient    : 1 to skip malformed lines (see the diags of the list), 0 to
+ *              fail on the first one.
+ * verbose    : if set to 1 verbose mode. 0 otherwise.
  * Failures are handled internally.
  */
-void fscan_words(FILE* input, word_list* list, int verbose){
-  // For getline
-  char* line = NULL;
-  size_t nbyte = 0;
-  ssize_t nb_read;
-
-  // For parsing
-  char wrd[MAX_WORD_SIZE + MAX_DEF_SIZE + 1];
-  char def[MAX_WORD_SIZE + MAX_DEF_SIZE + 1];
-  int ret_scan;
-
-  // For length checking
-  size_t len;
-
-  // Others
-  int lnum = 1;
-  char* wordpt;
-  word* wltmp = NULL;
+void fscan_words(FILE* input, word_list* list, int nb_threads, int lenient,
+                 int verbose){
+  struct stat st;
   int i;
 
   // Initial memory allocation.
@@ -59,104 +347,152 @@ void fscan_words(FILE* input, word_list* list, int verbose){
     fprintf(stderr, "Memory allocation error in fscan_words...\n");
     exit(EXIT_FAILURE);
   }
-  (*list)->l = malloc(INIT_NB * sizeof(word));
-  if(NULL == (*list)->l){
-    fprintf(stderr, "Memory allocation error in fscan_words...\n");
-    exit(EXIT_FAILURE);
-  }
+  (*list)->l = NULL;
   (*list)->next_free = 0;
-  (*list)->size = INIT_NB;
-
-  // Looping through the file.
-  nb_read = getline(&line, &nbyte, input);
-  while(1 < nb_read){
-    // Check if line not too long
-    if(nb_read > MAX_WORD_SIZE + MAX_DEF_SIZE + 1){
-      fprintf(stderr, "Parsing error, at line %i... (line too long)\n", lnum);
-      free(line);
-      free_words(*list);
-      exit(EXIT_FAILURE);
-    }
+  (*list)->size = 0;
+  (*list)->data = NULL;
+  (*list)->data_size = 0;
+  (*list)->mapped = 0;
+  (*list)->compiled = 0;
+  (*list)->index = NULL;
+  (*list)->diags = NULL;
+  (*list)->nb_diags = 0;
+  arena_init(&(*list)->mem, 0);
 
-    // Parsing into word and def.
-    ret_scan = sscanf(line, "%s : %[^\n]s\n", wrd, def);
-    if(EOF == ret_scan || 2 > ret_scan){
-      fprintf(stderr, "Parsing error, at line %i... (no parse)\n", lnum);
-      free(line);
-      free_words(*list);
-      exit(EXIT_FAILURE);
+  // Map the file in memory, or read it if it is not a regular file.
+  if((0 == fstat(fileno(input), &st)) && S_ISREG(st.st_mode) &&
+     (st.st_size > 0)){
+    (*list)->data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+                         fileno(input), 0);
+    if(MAP_FAILED == (*list)->data){
+      (*list)->data = NULL;
+    }else{
+      (*list)->data_size = st.st_size;
+      (*list)->mapped = 1;
     }
-
-    // Checking sizes.
-    len = strlen(wrd);
-    if(len < MIN_WORD_SIZE || len > MAX_WORD_SIZE){
-      fprintf(stderr, "Parsing error, at line %i... (wrong word size)\n", lnum);
-      fprintf(stderr, "Size must be between %i and %i.\n", MIN_WORD_SIZE,
-              MAX_WORD_SIZE);
-      free(line);
+  }
+  if(NULL == (*list)->data){
+    if(NULL == ((*list)->data = read_all(input, &(*list)->data_size))){
+      fprintf(stderr, "Error while reading the words file...\n");
       free_words(*list);
       exit(EXIT_FAILURE);
     }
-    len = strlen(def);
-    if(len < MIN_DEF_SIZE || len > MAX_DEF_SIZE){
-      fprintf(stderr, "Parsing error, at line %i... (wrong clue size)\n", lnum);
-      fprintf(stderr, "Size must be between %i and %i.\n", MIN_DEF_SIZE,
-              MAX_DEF_SIZE);
-      free(line);
+  }
+
+  // A compiled list is used as is (it was checked when compiled).
+  if(dict_is_compiled((*list)->data, (*list)->data_size)){
+    if(0 != dict_open(*list)){
       free_words(*list);
       exit(EXIT_FAILURE);
     }
+    if(verbose)
+      fprintf(stderr, "Compiled list: %d words.\n", (*list)->next_free);
+    return;
+  }
 
-    // Do the write and update
-    strncpy((*list)->l[(*list)->next_free].w, wrd, MAX_WORD_SIZE + 1);
-    strncpy((*list)->l[(*list)->next_free].d, def, MAX_DEF_SIZE + 1);
-    (*list)->l[(*list)->next_free].used = 0;
-    if(verbose){
-      fprintf(stderr, "Word scaned : ");
-      wordpt = (*list)->l[(*list)->next_free].w;
-      for(i = 0; i < MAX_WORD_SIZE && wordpt[i] != '\0'; i++)
-        putc(wordpt[i], stderr);
-      for( ; i < MAX_WORD_SIZE; i++) putc(' ', stderr);
-      fprintf(stderr, " = %s\n", (*list)->l[(*list)->next_free].d);
-    }
-    (*list)->next_free++;
-
-    // Check if need to increase array size.
-    if((unsigned) (*list)->next_free >= (*list)->size){
-      (*list)->size *= 2;
-      if(NULL == (wltmp = realloc((*list)->l, (*list)->size * sizeof(word)))){
-        fprintf(stderr, "Memory reallocation error in fscan_words...\n");
-	free(line);
-	free_words(*list);
-        exit(EXIT_FAILURE);
-      }
-      (*list)->l = wltmp;
-    }
+  // Otherwise the clues stay in the text of the file.
+  if((*list)->mapped)
+    madvise((*list)->data, (*list)->data_size, MADV_SEQUENTIAL);
+  (*list)->text = (*list)->data;
+  (*list)->text_size = (*list)->data_size;
+  if((*list)->text_size > INT_MAX){
+    // The clues are referenced by their offset (int) in the text.
+    fprintf(stderr, "The words file is too large...\n");
+    free_words(*list);
+    exit(EXIT_FAILURE);
+  }
+  if(0 != scan_text(*list, nb_threads, lenient, verbose)){
+    free_words(*list);
+    exit(EXIT_FAILURE);
+  }
+  if(verbose){
+    for(i = 0; i < (*list)->next_free; i++)
+      fprintf(stderr, "Word scaned : %-*s = %.*s\n", MAX_WORD_SIZE,
+              (*list)->l[i].w, WORD_CLUE_LEN(*list, i), WORD_CLUE(*list, i));
+  }
 
-    // Reinit
-    nb_read = getline(&line, &nbyte, input);
-    lnum++;
+  // Build the letter index.
+  if(0 != index_words(*list)){
+    free_words(*list);
+    exit(EXIT_FAILURE);
   }
+}
 
-  // Free memory
-  free(line);
+/*
+ * Print the diagnostics of the malformed lines skipped by fscan_words.
+ * out : the output.
+ * wl  : the word list.
+ */
+void fprint_diags(FILE* out, word_list wl){
+  int i;
+
+  for(i = 0; i < wl->nb_diags; i++)
+    fprint_diag(out, "Line skipped", &wl->diags[i]);
 }
 
 /*
- * Free the memory inside a word_list.
- * wl : the word list.
+ * Compute the length and letters mask of a word.
+ * w : the word (its characters must be set).
  */
-void free_words(word_list wl){
-  free(wl->l);
-  free(wl);
+void word_info(word* w){
+  int i;
+
+  w->letters = 0;
+  for(i = 0; '\0' != w->w[i]; i++)
+    w->letters |= WORD_LETTER(w->w[i]);
+  w->len = i;
 }
 
 /*
- * Mark every word to unused.
+ * Build the letter index of a list of words (letter -> (word, position)).
  * wl : the word list.
+ * Returns 0 if all went well, -1 otherwise.
  */
-void all_words_unused(word_list wl){
-  int i;
+int index_words(word_list wl){
+  int count[256];
+  int i, j, c, nb;
+  unsigned char* w;
+
+  // Count the occurences of each letter.
+  memset(count, 0, sizeof(count));
+  nb = 0;
   for(i = 0; i < wl->next_free; i++)
-    wl->l[i].used = 0;
+    for(w = (unsigned char*) wl->l[i].w; '\0' != *w; w++){
+      count[*w]++;
+      nb++;
+    }
+
+  // Compute where the occurences of each letter start.
+  wl->index_start[0] = 0;
+  for(c = 0; c < 256; c++)
+    wl->index_start[c + 1] = wl->index_start[c] + count[c];
+
+  // Fill the index (in the order of the list).
+  if(NULL == (wl->index = arena_alloc(&wl->mem, nb * sizeof(word_pos)))){
+    fprintf(stderr, "Memory allocation error in index_words...\n");
+    return -1;
+  }
+  memcpy(count, wl->index_start, sizeof(count));
+  for(i = 0; i < wl->next_free; i++){
+    w = (unsigned char*) wl->l[i].w;
+    for(j = 0; j < wl->l[i].len; j++){
+      wl->index[count[w[j]]].w = i;
+      wl->index[count[w[j]]].pos = j;
+      count[w[j]]++;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Free the memory inside a word_list.
+ * wl : the word list.
+ */
+void free_words(word_list wl){
+  arena_free(&wl->mem);
+  if(wl->mapped) munmap(wl->data, wl->data_size);
+  else free(wl->data);
+  free(wl);
 }
+
@@ -28,17 +28,54 @@
 #ifndef __WORD_H__
 #define __WORD_H__
 
+#include <stdio.h>
+#include <stdint.h>
 #include "const.h"
+#include "arena.h"
+
+/*
+ * Size of the storage of a word (the word and '\0' padding). Words are read
+ * as a whole by SIMD instructions (see match.h).
+ */
+#define WORD_STORAGE 16
+
+/*
+ * Bit of a letter in the letters mask of a word. Letters are folded on 32
+ * bits (case is ignored), so two words with no common bit cannot cross.
+ */
+#define WORD_LETTER(c) (((uint32_t) 1) << ((c) & 31))
 
 /*
  * Structure representing a word.
  */
 typedef struct __word__{
-  char w[MAX_WORD_SIZE + 1]; // The word.
-  char d[MAX_DEF_SIZE + 1];  // The clue.
-  int used;              // Set to 1 if used in the crossword. 0 otherwise.
+  char w[WORD_STORAGE];  // The word.
+  int d;                 // Offset of the clue in the text of the list.
+  int dlen;              // Length of the clue (not '\0' terminated, any
+                         // length).
+  int len;               // Length of the word.
+  uint32_t letters;      // Mask of the letters of the word (WORD_LETTER).
 }word;
 
+/*
+ * Structure representing an occurence of a letter in a word of the list.
+ */
+typedef struct __word_pos__{
+  int w;                 // Index of the word in the list.
+  int pos;               // Position of the letter in the word.
+}word_pos;
+
+/*
+ * Diagnostic about a malformed line of a words file.
+ */
+typedef struct __scan_diag__{
+  int line;              // Number of the line (starting at 1).
+  const char* msg;       // Reason (static string).
+  int min;               // Minimal size of the faulty element (if max != 0).
+  int max;               // Maximal size of the faulty element, 0 if the line
+                         // was not rejected because of a size.
+}scan_diag;
+
 /*
  * Structure representing a list of words.
  */
@@ -46,27 +83,69 @@ typedef struct __word_list__{
   word* l;               // The actual list.
   int next_free;         // The next index where to write a word.
   size_t size;           // The capacity of the list.
+  char* data;            // The content of the words file.
+  size_t data_size;      // Size of the content.
+  int mapped;            // 1 if the content is mapped in memory (mmap). 0
+                         // if it was read in an allocated buffer.
+  int compiled;          // 1 if the file is a compiled list (see dict.h): l
+                         // and index then point into the content.
+  char* text;            // The text holding the clues (in the content).
+  size_t text_size;      // Size of the text.
+  word_pos* index;       // Occurences of the letters, sorted by letter.
+  int index_start[257];  // Occurences of letter c are between index_start[c]
+                         // (included) and index_start[c + 1] (excluded).
+  scan_diag* diags;      // Malformed lines skipped (lenient parsing).
+  int nb_diags;          // Number of malformed lines skipped.
+  arena mem;             // Memory of the words, the index and the diags
+                         // (empty for a compiled list).
 }*word_list;
 
 /*
- * Function that scanning a file for words.
- * input : the file.
- * list  : the list of words scanned.
- * verbose : if set to 1 verbose mode. O otherwise.
+ * The clue of the word number i of a list (use with "%.*s", see WORD_CLUE_LEN).
+ */
+#define WORD_CLUE(wl, i) ((wl)->text + (wl)->l[i].d)
+#define WORD_CLUE_LEN(wl, i) ((wl)->l[i].dlen)
+
+/*
+ * Function that scanning a file for words. The file is mapped in memory
+ * when possible, and the clues are left in place. Large files are split at
+ * line boundaries and parsed by several threads. The file can also be a
+ * compiled list (see dict.h), used as is.
+ * input      : the file.
+ * list       : the list of words scanned.
+ * nb_threads : maximal number of threads for the parsing.
+ * lenient    : 1 to skip malformed lines (see the diags of the list), 0 to
+ *              fail on the first one.
+ * verbose    : if set to 1 verbose mode. O otherwise.
  * Failures are handled internally.
  */
-void fscan_words(FILE* input, word_list* list, int verbose);
+void fscan_words(FILE* input, word_list* list, int nb_threads, int lenient,
+                 int verbose);
 
 /*
- * Free the memory inside a word_list.
+ * Print the diagnostics of the malformed lines skipped by fscan_words.
+ * out : the output.
+ * wl  : the word list.
+ */
+void fprint_diags(FILE* out, word_list wl);
+
+/*
+ * Compute the length and letters mask of a word.
+ * w : the word (its characters must be set).
+ */
+void word_info(word* w);
+
+/*
+ * Build the letter index of a list of words (letter -> (word, position)).
  * wl : the word list.
+ * Returns 0 if all went well, -1 otherwise.
  */
-void free_words(word_list wl);
+int index_words(word_list wl);
 
 /*
- * Mark every word to unused.
+ * Free the memory inside a word_list.
  * wl : the word list.
  */
-void all_words_unused(word_list wl);
+void free_words(word_list wl);
 
 #endif